@@ -1,12 +1,15 @@
 #pragma once
 
 #include <map>
+#include <vector>
 
 #include "game/state.hpp"
 
 namespace pnkd
 {
 
+auto show_solution(game_state_t const &solution) -> void;
 auto show_solutions(std::map<std::size_t, game_state_t> const &solutions) -> void;
+auto show_alternatives(std::map<std::size_t, std::vector<game_state_t>> const &alternatives) -> void;
 
 } // namespace pnkd
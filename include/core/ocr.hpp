@@ -7,14 +7,20 @@
 
 #include "game/goal.hpp"
 
+#include "utils/cancellation.hpp"
+
 namespace pnkd
 {
 
+// Every character that can appear in a code, or between them
+constexpr auto code_characters = "BD5E91C7AF \n";
+
 auto preprocess_image(cv::Mat const &raw_img, double w_scale, double x_scale, double h_scale, double y_scale, double thresh = 80) -> cv::Mat;
 
-auto get_string_from_image(cv::Mat const &raw_img, std::string const &tessdata_path = "tessdata", std::string const &char_list = "BD5E91C7AF \n") -> std::string;
+// These all give up and return nothing as soon as they can once the token is cancelled
+auto get_string_from_image(cv::Mat const &raw_img, std::string const &tessdata_path = "tessdata", std::string const &char_list = code_characters, cancellation_token_t const &cancel = {}) -> std::string;
 
-auto get_grid_from_img(cv::Mat const &raw_img, std::string const &tessdata_path = "tessdata") -> std::vector<std::string>;
-auto get_goal_list_from_img(cv::Mat const &raw_img, std::string const &tessdata_path = "tessdata") -> pnkd::goal_list_t;
+auto get_grid_from_img(cv::Mat const &raw_img, std::string const &tessdata_path = "tessdata", cancellation_token_t const &cancel = {}) -> std::vector<std::string>;
+auto get_goal_list_from_img(cv::Mat const &raw_img, std::string const &tessdata_path = "tessdata", cancellation_token_t const &cancel = {}) -> pnkd::goal_list_t;
 
 } // namespace pnkd
\ No newline at end of file
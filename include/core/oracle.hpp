@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "game/board.hpp"
+#include "game/puzzle.hpp"
+#include "game/route.hpp"
+#include "game/symbol.hpp"
+
+namespace pnkd
+{
+
+// Answers "is there a legal route that spells this sequence of codes, and what is it?" without searching the grid.
+// Works forwards through the sequence one step at a time, keeping a bitmask of the cells each step could end on, and
+// alternating between moving along rows and columns just like game_state_t does. Those masks don't know which cells
+// have already been used, so that's only checked when a route is rebuilt from them - either by find(), or by a caller
+// that walks the masks from reachable() with checks of its own
+class path_oracle_t
+{
+public:
+  // Matches every cell, for moves whose code doesn't matter
+  static constexpr symbol_t any_symbol = alphabet_t::invalid_symbol;
+
+private:
+  dynamic_board_t m_board;
+  std::size_t m_buffer_size;
+
+  std::vector<cell_mask_t> m_symbol_masks;
+  cell_mask_t m_all_cells = 0;
+
+  [[nodiscard]] auto cells_matching(symbol_t const symbol) const -> cell_mask_t;
+
+  template<typename Board>
+  [[nodiscard]] auto reachable_on(Board const &board, symbol_seq_t const &pattern) const -> std::vector<cell_mask_t>;
+  template<typename Board>
+  auto rebuild(Board const &board, std::vector<cell_mask_t> const &alive, std::size_t const step, std::size_t const from, cell_mask_t const used, route_t &route) const -> bool;
+
+public:
+  explicit path_oracle_t(puzzle_t const &puzzle);
+
+  // The cells each step of a route spelling the pattern could be on, keeping only those that can still reach the end of
+  // it. Empty if nothing can spell it
+  [[nodiscard]] auto reachable(symbol_seq_t const &pattern) const -> std::vector<cell_mask_t>;
+
+  // The first route that spells the pattern without reusing any cells
+  [[nodiscard]] auto find(symbol_seq_t const &pattern) const -> std::optional<route_t>;
+};
+
+} // namespace pnkd
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "core/transposition.hpp"
+
+#include "game/state.hpp"
+
+namespace pnkd
+{
+
+// A filter the puzzler runs every new state through before exploring it. A stage must only reject a state if some
+// state it has already admitted can reach everything the rejected one could, in no more moves
+class pruning_stage_t
+{
+private:
+  std::size_t m_removed = 0;
+
+protected:
+  virtual auto keep(game_state_t const &game_state) -> bool = 0;
+
+public:
+  pruning_stage_t() = default;
+  pruning_stage_t(pruning_stage_t const &) = delete;
+  auto operator=(pruning_stage_t const &) -> pruning_stage_t & = delete;
+  virtual ~pruning_stage_t() = default;
+
+  [[nodiscard]] virtual auto name() const -> std::string = 0;
+
+  // An empty stage set up the same way as this one, for another thread to use
+  [[nodiscard]] virtual auto fresh() const -> std::unique_ptr<pruning_stage_t> = 0;
+
+  // Forget every state seen so far (but not how many have been removed)
+  virtual auto reset() -> void = 0;
+
+  // Called by the breadth-first search each time it moves down a level
+  virtual auto next_level() -> void {}
+
+  auto admit(game_state_t const &game_state) -> bool;
+
+  [[nodiscard]] auto removed() const -> std::size_t;
+};
+
+
+// Rejects states that have already been reached by a different route
+class transposition_stage_t : public pruning_stage_t
+{
+private:
+  std::size_t m_max_slots;
+  transposition_table_t m_table;
+
+protected:
+  auto keep(game_state_t const &game_state) -> bool override;
+
+public:
+  explicit transposition_stage_t(std::size_t const max_slots = 0);
+
+  [[nodiscard]] auto name() const -> std::string override;
+  [[nodiscard]] auto fresh() const -> std::unique_ptr<pruning_stage_t> override;
+  auto reset() -> void override;
+  auto next_level() -> void override;
+};
+
+
+// Rejects a state if another one is in the same place, facing the same way, with the same goal progress, and has only
+// used some of the cells this one has. Every route open to this state is open to that one too, and is shorter from there.
+// Groups are kept in an open-addressed table that stops growing at max_groups, after which newer groups overwrite older
+// ones (so some dominated states will get through)
+class dominance_stage_t : public pruning_stage_t
+{
+private:
+  struct group_key_t
+  {
+    std::uint64_t m_progress = 0;
+    std::uint8_t m_pos = 0;
+    bool m_direction = false;
+
+    auto operator==(group_key_t const &other) const -> bool
+    {
+      return this->m_progress == other.m_progress && this->m_pos == other.m_pos && this->m_direction == other.m_direction;
+    }
+  };
+
+  // Only the most recent move histories are kept for each group, so that memory doesn't grow with the search
+  static constexpr std::size_t max_histories = 32;
+
+  struct group_t
+  {
+    group_key_t m_key;
+    std::uint32_t m_generation = 0;
+    std::uint32_t m_count = 0;
+    std::array<std::uint64_t, max_histories> m_histories{};
+  };
+
+  static constexpr std::size_t initial_groups = 64;
+  static constexpr std::size_t max_probes = 8;
+
+  std::size_t m_max_groups;
+  std::vector<group_t> m_groups;
+  std::size_t m_size = 0;
+
+  // As with transposition_table_t, a group is only in use if it was written since the last reset()
+  std::uint32_t m_generation = 1;
+
+  auto find_group(group_key_t const &key) -> group_t &;
+  auto grow() -> void;
+
+protected:
+  auto keep(game_state_t const &game_state) -> bool override;
+
+public:
+  static constexpr std::size_t default_max_groups = std::size_t{1} << 12;
+
+  explicit dominance_stage_t(std::size_t const max_groups = default_max_groups);
+
+  [[nodiscard]] auto name() const -> std::string override;
+  [[nodiscard]] auto fresh() const -> std::unique_ptr<pruning_stage_t> override;
+  auto reset() -> void override;
+
+  // How many groups are remembered, and how many there's room for
+  [[nodiscard]] auto size() const -> std::size_t;
+  [[nodiscard]] auto capacity() const -> std::size_t;
+};
+
+} // namespace pnkd
@@ -1,30 +1,251 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
 #include <queue>
+#include <memory>
+#include <mutex>
+#include <limits>
 #include <vector>
 #include <map>
+#include <optional>
+#include <string>
 
+#include "core/pruning.hpp"
+
+#include "game/arena.hpp"
+#include "game/route.hpp"
 #include "game/state.hpp"
 
+#include "utils/cancellation.hpp"
+
 namespace pnkd
 {
 
+enum class search_strategy_t
+{
+  breadth_first, // Expands every level of the tree in turn - simple, but holds a whole level in memory at once
+  depth_first,   // Branch-and-bound - memory only grows with the buffer size
+  best_first,    // Expands whichever state could still complete the most goals first, so good routes turn up early
+  sequence_first, // Works out what the goals could spell, then looks for routes that spell it (see sequencer)
+  beam            // Only keeps the most promising few states at each depth - quick on big puzzles, but might not find the best routes
+};
+
+// Called with the best routes found so far each time the search improves on them
+using progress_callback_t = std::function<void(std::map<std::size_t, game_state_t> const &)>;
+
+auto parse_search_strategy(std::string const &name) -> std::optional<search_strategy_t>;
+// Not used by the search itself, which reports the best route for every combination of goals, but for anyone who only
+// wants the routes that no other route beats
+auto remove_dominated(std::map<std::size_t, game_state_t> &solutions) -> void;
+auto beats(game_state_t const &candidate, route_t const &route, game_state_t const &incumbent) -> bool;
+
+// How far an approximate search's routes fall short of the optimal ones. For each combination of goals the optimal
+// search reported, the approximate search's answer is its fewest moves to complete at least those goals
+struct quality_gap_t
+{
+  std::size_t m_combos = 0;       // Combinations the optimal search reported
+  std::size_t m_optimal = 0;      // Found in as few moves
+  std::size_t m_missed = 0;       // Not found at all
+  std::size_t m_extra_moves = 0;  // Added up over the ones found in more moves
+  std::size_t m_goals_missed = 0; // How many fewer goals the approximate search's best route completes than the optimal one
+};
+
+auto measure_quality_gap(std::map<std::size_t, game_state_t> const &optimal, std::map<std::size_t, game_state_t> const &approximate) -> quality_gap_t;
+
+// Later goals are worth more in the game, so weight them by where they are in the list - 1 for the first, 2 for the second, ...
+auto goal_weights_by_order(std::size_t const num_goals) -> std::vector<std::size_t>;
+
 class puzzler
 {
+  // A subtree still to be searched, and the route to its root
+  struct search_task_t
+  {
+    game_state_t m_state;
+    route_t m_route;
+  };
+
+  // A state waiting to be expanded by the best-first search, and how promising it looks. There can be a lot of these, so
+  // the state is packed and its route is left in the arena, only rebuilt if it completes something
+  struct frontier_entry_t
+  {
+    packed_state_t m_state;
+    std::uint8_t m_estimate;
+    std::uint8_t m_moves_taken;
+  };
+
+  // A state on the next level of the beam search, and how far it's got. Packed for the same reason as frontier_entry_t
+  struct beam_entry_t
+  {
+    packed_state_t m_state;
+    std::uint8_t m_completed;
+    std::uint8_t m_reachable;
+    std::uint8_t m_progress;
+  };
+
+  // Everything one thread needs to run a depth-first search of its own
+  struct search_worker_t
+  {
+    std::vector<std::unique_ptr<pruning_stage_t>> m_pruning_stages;
+
+    // Best state found so far for each combination of completed goals
+    std::map<std::size_t, game_state_t> m_best;
+
+    // When keeping alternatives, the best few for each combination, as heaps with the worst of them first
+    std::map<std::size_t, std::vector<game_state_t>> m_alternatives;
+    std::size_t m_states_explored = 0;
+    std::size_t m_states_pruned = 0;
+
+    // The owner works from the back, and other workers steal from the front (where the biggest subtrees are)
+    std::deque<search_task_t> m_tasks;
+    std::mutex m_tasks_mutex;
+  };
 
 private:
+  search_strategy_t m_strategy;
+  std::size_t m_threads;
+
   std::queue<game_state_t> m_game_states;
+  state_arena_t m_arena;
   bool should_continue = true;
-  std::vector<game_state_t> m_candidates;
   std::size_t m_total_goals;
 
+  // Any moves made before the state the search starts from, which every route it reports has to start with
+  route_t m_prefix;
+
+  // The breadth-first search's best candidate so far for each combination of completed goals, indexed by that combination
+  struct candidate_t
+  {
+    game_state_t m_state;
+    std::size_t m_scoring_moves;
+  };
+
+  std::vector<std::optional<candidate_t>> m_candidates;
+  std::size_t m_candidates_found = 0;
+
+  // The first worker's pruning stages are also the ones used by the breadth-first search. The depth-first search caps
+  // the size of its transposition table to keep its memory bounded, as the dominance stage always does
+  static constexpr std::size_t depth_first_table_slots = std::size_t{1} << 16;
+  std::vector<std::unique_ptr<search_worker_t>> m_workers;
+
+  // For each combination of goals, the fewest moves of any route found so far that completes exactly those goals.
+  // Every worker shares these, and they only ever go down
+  static constexpr std::size_t no_bound = std::numeric_limits<std::size_t>::max();
+  std::vector<std::atomic<std::size_t>> m_bounds;
+
+  // How many routes to keep for each combination. With more than one, a combination's bound is the worst of the routes
+  // kept for it
+  std::size_t m_alternatives = 1;
+
+  // When looking for the single route worth the most, what each combination of goals is worth and the weighted_score() of
+  // the best route found so far. Every worker shares the latter, and it only ever goes up
+  std::vector<std::size_t> m_combo_weights;
+  std::atomic<std::uint64_t> m_incumbent{0};
+
+  // How many states the beam search keeps at each depth. On the benchmark puzzles ("Beam search quality"), this many
+  // finds the most goals every time and the fewest moves for most combinations, in under a tenth of the exact time
+  static constexpr std::size_t default_beam_width = 1024;
+  std::size_t m_beam_width = default_beam_width;
+
+  // When searching in parallel, routes that tie with the bound have to be kept, so that no matter which thread finds
+  // one first, the same route (the first in search order) is reported
+  bool m_keep_ties = false;
+
+  // Subtrees with fewer moves than this left to play are quicker to search than to hand to another worker
+  static constexpr std::size_t min_moves_to_share = 3;
+  std::atomic<std::size_t> m_tasks_pending{0};
+  std::atomic<std::size_t> m_workers_idle{0};
+
+  // Idle workers sleep until a task is shared or the search runs out of tasks. The count of tasks ever shared lets a
+  // worker tell whether any turned up since it last looked, so a wake-up can't be missed
+  std::mutex m_idle_mutex;
+  std::condition_variable m_work_available;
+  std::size_t m_tasks_shared = 0;
+
+  // Once the deadline passes (or the solve is cancelled) every search stops where it is. Anything found in no more moves
+  // than the fewest taken by any state that was left unexplored is still proven optimal, since every route through those
+  // states is longer
+  static constexpr std::size_t states_per_clock_check = 1024;
+  std::optional<std::chrono::steady_clock::time_point> m_deadline;
+  cancellation_token_t m_cancel;
+  std::atomic<bool> m_stopping{false};
+  std::atomic<std::size_t> m_unexplored_moves{no_bound};
+
+  // The best routes found so far, kept apart from the search's own so that they can be handed out while it runs. Only
+  // one thread calls the callback at a time
+  progress_callback_t m_on_progress;
+  std::map<std::size_t, game_state_t> m_progress;
+  std::mutex m_progress_mutex;
+
+  [[nodiscard]] auto admit(search_worker_t &worker, game_state_t const &game_state) -> bool;
+  [[nodiscard]] auto pruning_summary() const -> std::string;
+  auto search_subtree(search_worker_t &worker, game_state_t const &game_state, route_t &route) -> void;
+
+  // The search loops themselves, instantiated for each board_t the game uses (see dispatch_board())
+  template<typename Board>
+  auto search_breadth_first(Board const &board) -> void;
+  template<typename Board>
+  auto search_best_first(Board const &board) -> void;
+  template<typename Board>
+  auto search_beam(Board const &board) -> void;
+  template<typename Board>
+  auto search_depth_first(Board const &board, search_worker_t &worker, game_state_t const &game_state, route_t &route) -> void;
+  auto run_worker(std::size_t const worker_num) -> void;
+  auto take_task(std::size_t const worker_num) -> std::optional<search_task_t>;
+  auto share_task(search_worker_t &worker, search_task_t task) -> void;
+  [[nodiscard]] auto stopping(std::size_t const states_explored) -> bool;
+  auto stop_unexplored(std::size_t const moves_taken) -> void;
+  auto publish(game_state_t const &candidate, route_t const &route) -> void;
+  [[nodiscard]] auto full_route(route_t const &route) const -> route_t;
+  [[nodiscard]] auto is_proven(game_state_t const &solution) const -> bool;
+  auto mark_proven(std::map<std::size_t, game_state_t> &solutions) const -> void;
+  auto record_candidate(game_state_t const &candidate) -> void;
+  auto record_best(std::map<std::size_t, game_state_t> &best, game_state_t const &candidate, route_t const &route) -> void;
+  auto record_alternative(std::vector<game_state_t> &alternatives, game_state_t const &candidate, route_t const &route) -> void;
+  auto record(search_worker_t &worker, game_state_t const &candidate, route_t const &route) -> void;
+  auto tighten_bounds(std::size_t const goal_combo, std::size_t const scoring_moves) -> void;
+  [[nodiscard]] auto can_improve(game_state_t const &game_state) const -> bool;
+  [[nodiscard]] auto optimistic_goals(game_state_t const &game_state) const -> std::size_t;
+  [[nodiscard]] auto beam_entry(game_state_t const &state) const -> beam_entry_t;
+  [[nodiscard]] auto can_improve_after(std::size_t const moves_taken) const -> bool;
+
 public:
   puzzler() = delete;
-  explicit puzzler(game_state_t const &game_state);
+  explicit puzzler(game_state_t const &game_state, search_strategy_t const strategy = search_strategy_t::breadth_first, std::size_t const threads = 1);
+
+  // Every puzzler starts out with the transposition and dominance stages. Clear them first to run with different ones
+  auto add_pruning_stage(std::unique_ptr<pruning_stage_t> stage) -> void;
+  auto clear_pruning_stages() -> void;
+  auto on_progress(progress_callback_t callback) -> void;
+  auto set_beam_width(std::size_t const width) -> void;
 
   auto calculate_all_routes() -> void;
   auto pick_best_routes() -> std::map<std::size_t, game_state_t>;
-  auto solve() -> std::map<std::size_t, game_state_t>;
+  auto branch_and_bound() -> std::map<std::size_t, game_state_t>;
+  auto best_first_search() -> std::map<std::size_t, game_state_t>;
+  auto beam_search() -> std::map<std::size_t, game_state_t>;
+  auto parallel_branch_and_bound() -> std::map<std::size_t, game_state_t>;
+  auto solve(std::optional<std::chrono::steady_clock::time_point> const deadline = std::nullopt, cancellation_token_t const &cancel = {}) -> std::map<std::size_t, game_state_t>;
+
+  // Solves on another thread. The puzzler has to outlive the future, and cancelling the token makes the search give up
+  // within a few thousand states and hand back whatever it had found
+  auto solve_async(std::optional<std::chrono::steady_clock::time_point> const deadline = std::nullopt, cancellation_token_t const &cancel = {}) -> std::future<std::map<std::size_t, game_state_t>>;
+
+  // Finds up to this many of the best routes for each combination of goals solve() would report, best first. Other
+  // routes to the same state are exactly what we're after here, so this always searches depth-first with no pruning
+  // stages other than the bounds
+  auto solve_alternatives(std::size_t const count, std::optional<std::chrono::steady_clock::time_point> const deadline = std::nullopt, cancellation_token_t const &cancel = {}) -> std::map<std::size_t, std::vector<game_state_t>>;
+
+  // Finds the route that completes the goals with the greatest total weight (one each, at least 1), then the one that does
+  // it in the fewest moves. Anything that can't beat the best route so far is pruned, so this always searches depth-first
+  auto solve_weighted(std::vector<std::size_t> const &weights, std::optional<std::chrono::steady_clock::time_point> const deadline = std::nullopt, cancellation_token_t const &cancel = {}) -> std::optional<game_state_t>;
+
+  // Solves once with the whole buffer, then works out what solve() would have found with each smaller buffer, by buffer size
+  auto solve_every_buffer(std::optional<std::chrono::steady_clock::time_point> const deadline = std::nullopt, cancellation_token_t const &cancel = {}) -> std::map<std::size_t, std::map<std::size_t, game_state_t>>;
 };
 
 } // namespace pnkd
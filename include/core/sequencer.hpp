@@ -0,0 +1,63 @@
+#pragma once
+
+#include <map>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "core/oracle.hpp"
+
+#include "game/route.hpp"
+#include "game/state.hpp"
+#include "game/symbol.hpp"
+
+#include "utils/cancellation.hpp"
+
+namespace pnkd
+{
+
+// Solves a puzzle the other way round to the puzzler. Rather than searching the grid for routes and seeing which goals
+// they complete, it works out which sequences of codes would complete each combination of goals, then looks for a route
+// that spells one of them. Produces the same solutions as puzzler::solve()
+class sequencer
+{
+  // A sequence of codes for a route to spell, and the goals it's meant to complete
+  struct target_t
+  {
+    symbol_seq_t m_pattern;
+    std::size_t m_goal_combo;
+
+    auto operator<(target_t const &other) const -> bool
+    {
+      return std::make_pair(this->m_pattern.size(), std::make_pair(this->m_pattern, this->m_goal_combo)) < std::make_pair(other.m_pattern.size(), std::make_pair(other.m_pattern, other.m_goal_combo));
+    }
+  };
+
+  // Stands in for moves whose code doesn't matter, like those needed to get to the start of a goal
+  static constexpr symbol_t any_symbol = path_oracle_t::any_symbol;
+
+private:
+  game_state_t m_root;
+  path_oracle_t m_oracle;
+  std::vector<symbol_seq_t> m_goal_symbols;
+
+  std::vector<target_t> m_targets;
+  std::map<std::size_t, game_state_t> m_best;
+  cancellation_token_t m_cancel;
+
+  auto build_targets() -> void;
+  auto add_targets(symbol_seq_t const &pattern, std::size_t const placed, std::size_t const goal_combo) -> void;
+  auto spell(game_state_t const &game_state, target_t const &target, std::vector<cell_mask_t> const &alive, route_t &route) const -> std::optional<game_state_t>;
+  auto record_best(game_state_t const &candidate, route_t const &route) -> void;
+
+public:
+  sequencer() = delete;
+  explicit sequencer(game_state_t const &game_state, cancellation_token_t cancel = {});
+
+  auto solve() -> std::map<std::size_t, game_state_t>;
+};
+
+// How many codes at the end of the pattern could double as the start of the goal, longest first (not counting the whole goal)
+auto overlaps(symbol_seq_t const &pattern, symbol_seq_t const &goal) -> std::vector<std::size_t>;
+
+} // namespace pnkd
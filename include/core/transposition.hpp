@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "game/state.hpp"
+
+namespace pnkd
+{
+
+// Remembers which states have already been seen, so that different routes arriving at the same state are only expanded once.
+// With a slot limit, the table stops growing and newer states overwrite older ones instead (so some repeats will be missed)
+class transposition_table_t
+{
+private:
+  struct slot_t
+  {
+    state_key_t m_key;
+    std::uint32_t m_generation = 0;
+  };
+
+  static constexpr std::size_t initial_slots = 1024;
+  static constexpr std::size_t max_probes = 8;
+
+  std::vector<slot_t> m_slots;
+  std::size_t m_size = 0;
+
+  // A slot is only in use if it was written since the last clear(), so clearing doesn't have to touch every slot
+  std::uint32_t m_generation = 1;
+  std::size_t m_max_slots;
+  std::size_t m_hits = 0;
+
+  auto grow() -> void;
+
+public:
+  explicit transposition_table_t(std::size_t const max_slots = 0);
+
+  auto insert(state_key_t const &key) -> bool;
+  auto clear() -> void;
+
+  [[nodiscard]] auto size() const -> std::size_t;
+  [[nodiscard]] auto hits() const -> std::size_t;
+};
+
+} // namespace pnkd
@@ -21,6 +21,15 @@ Options:
   -V, --verbose           Enable verbose logging (for debugging purposes - incompatible with quiet mode)
   -q, --quiet             Enable quiet mode. Only errors will be logged (incompatible with verbose mode)
   -t, --tessdata <path>   Path to the folder containing tesseract trained data
+  -s, --strategy <name>   Search strategy: bfs (breadth-first), dfs (depth-first branch-and-bound), best (best-first), seq (sequence-first) or beam (quick, but not always optimal) [default: bfs]
+  -j, --threads <count>   Number of threads to search with. More than one uses the depth-first search, unless the strategy is seq [default: 1]
+  -d, --deadline <ms>     Stop searching after this many milliseconds and show the best routes found so far, or 0 for no limit [default: 0]
+  -m, --max-buffer <n>    Also show what each bigger buffer size up to this one would unlock, from the same search [default: 0]
+  -r, --resume <moves>    Cells already picked, numbered from 0 along each row (like 0,15,17), to solve the rest of the puzzle from there
+  -k, --alternatives <n>  Show up to this many routes for each combination of target sequences, best first, in case the best one is blocked [default: 1]
+  -b, --beam-width <n>    How many routes the beam strategy keeps at each move. Wider finds better routes, but takes longer [default: 1024]
+  -w, --weights <list>    Show only the route worth the most, where each target sequence is worth this much (like 1,2,5), or "order" to make later ones worth more
+  --hide-dominated        Leave out any route that another one beats, by completing all of the same target sequences and more in as few moves
 )";
 
 } // namespace pnkd
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "game/route.hpp"
+
+namespace pnkd
+{
+
+// States are identified by their index in the arena that created them
+using state_id_t = std::uint32_t;
+
+static constexpr state_id_t no_state = std::numeric_limits<state_id_t>::max();
+
+// Records the lineage of every state created during a solve, so a state only needs to carry its own index and its parent's.
+// Routes are rebuilt from these links on demand, rather than every state dragging a copy of its whole route around
+class state_arena_t
+{
+private:
+  struct entry_t
+  {
+    state_id_t m_parent;
+    std::uint8_t m_move;
+  };
+
+  std::vector<entry_t> m_entries;
+
+public:
+  state_arena_t() = default;
+
+  auto add(state_id_t const parent, std::size_t const move) -> state_id_t;
+  auto clear() -> void;
+
+  [[nodiscard]] auto parent(state_id_t const id) const -> state_id_t;
+  [[nodiscard]] auto move(state_id_t const id) const -> std::size_t;
+  [[nodiscard]] auto route(state_id_t const id) const -> route_t;
+  // Whether the route to one state comes before the route to another, for two states the same number of moves from the
+  // root. Only walks back as far as where the routes split, without rebuilding either of them
+  [[nodiscard]] auto route_before(state_id_t const lhs, state_id_t const rhs) const -> bool;
+  [[nodiscard]] auto size() const -> std::size_t;
+};
+
+} // namespace pnkd
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace pnkd
+{
+
+// One bit for each cell of the grid
+using cell_mask_t = std::uint64_t;
+
+// The shape of a square grid, fixed at compile time. Every table is built by the compiler, and every loop over the rows or
+// columns has a known trip count, so the solver kernels instantiated on one of these can be unrolled and vectorised
+template<std::size_t Width>
+class board_t
+{
+public:
+  static constexpr std::size_t width = Width;
+  static constexpr std::size_t size = Width * Width;
+
+  static_assert(Width > 0 && size <= 64, "Every cell needs a bit of a cell_mask_t");
+
+private:
+  static constexpr cell_mask_t top_row = (cell_mask_t{1} << Width) - 1;
+
+  // A bit at the start of every row - multiplying a row's worth of bits by this copies them onto every row
+  static constexpr auto make_row_starts() -> cell_mask_t
+  {
+    cell_mask_t starts = 0;
+
+    for (std::size_t row = 0; row < Width; ++row)
+    {
+      starts |= cell_mask_t{1} << (row * Width);
+    }
+
+    return starts;
+  }
+
+  static constexpr cell_mask_t row_starts = make_row_starts();
+
+  static constexpr auto make_line_masks(bool const vertical) -> std::array<cell_mask_t, size>
+  {
+    auto masks = std::array<cell_mask_t, size>{};
+
+    for (std::size_t pos = 0; pos < size; ++pos)
+    {
+      masks[pos] = vertical ? row_starts << (pos % Width) : top_row << ((pos / Width) * Width);
+    }
+
+    return masks;
+  }
+
+  static constexpr std::array<cell_mask_t, size> row_masks = make_line_masks(false);
+  static constexpr std::array<cell_mask_t, size> col_masks = make_line_masks(true);
+
+public:
+  [[nodiscard]] constexpr auto grid_width() const -> std::size_t
+  {
+    return width;
+  }
+
+  [[nodiscard]] constexpr auto all_cells() const -> cell_mask_t
+  {
+    return size == 64 ? ~cell_mask_t{0} : (cell_mask_t{1} << size) - 1;
+  }
+
+  // Every cell in the same row (or column) as pos
+  [[nodiscard]] constexpr auto line_mask(std::size_t const pos, bool const vertical) const -> cell_mask_t
+  {
+    return vertical ? col_masks[pos] : row_masks[pos];
+  }
+
+  // Every cell that shares a row (or column) with any of the given cells
+  [[nodiscard]] constexpr auto spread(cell_mask_t const cells, bool const vertical) const -> cell_mask_t
+  {
+    cell_mask_t result = 0;
+
+    if (vertical)
+    {
+      // Fold every row onto the top one to find the columns in use, then copy that back down
+      cell_mask_t used = 0;
+
+      for (std::size_t row = 0; row < Width; ++row)
+      {
+        used |= cells >> (row * Width);
+      }
+
+      result = (used & top_row) * row_starts;
+    } else
+    {
+      for (std::size_t row = 0; row < Width; ++row)
+      {
+        cell_mask_t const line = top_row << (row * Width);
+        result |= (cells & line) != 0 ? line : 0;
+      }
+    }
+
+    return result;
+  }
+};
+
+
+// The same interface for any other width, with the tables built when the puzzle is
+class dynamic_board_t
+{
+private:
+  std::size_t m_grid_width = 0;
+  cell_mask_t m_all_cells = 0;
+
+  // For each cell, every cell in the same row (and column)
+  std::vector<cell_mask_t> m_row_masks;
+  std::vector<cell_mask_t> m_col_masks;
+
+  // Every cell in each row (and column), by row (or column) number
+  std::vector<cell_mask_t> m_rows;
+  std::vector<cell_mask_t> m_cols;
+
+public:
+  dynamic_board_t() = default;
+  explicit dynamic_board_t(std::size_t const grid_width);
+
+  [[nodiscard]] auto grid_width() const -> std::size_t
+  {
+    return this->m_grid_width;
+  }
+
+  [[nodiscard]] auto all_cells() const -> cell_mask_t
+  {
+    return this->m_all_cells;
+  }
+
+  [[nodiscard]] auto line_mask(std::size_t const pos, bool const vertical) const -> cell_mask_t
+  {
+    return vertical ? this->m_col_masks[pos] : this->m_row_masks[pos];
+  }
+
+  [[nodiscard]] auto spread(cell_mask_t const cells, bool const vertical) const -> cell_mask_t;
+};
+
+
+// Calls kernel with the compile-time board for the grid's width if there is one, or the runtime board otherwise. The game
+// only ever uses grids between 5x5 and 8x8 (and 8x8 is as big as a cell_mask_t goes)
+template<typename Kernel>
+auto dispatch_board(dynamic_board_t const &board, Kernel &&kernel) -> decltype(kernel(board))
+{
+  switch (board.grid_width())
+  {
+    case 5:
+      return kernel(board_t<5>{});
+    case 6:
+      return kernel(board_t<6>{});
+    case 7:
+      return kernel(board_t<7>{});
+    case 8:
+      return kernel(board_t<8>{});
+    default:
+      return kernel(board);
+  }
+}
+
+} // namespace pnkd
@@ -2,37 +2,55 @@
 
 #include <string>
 #include <vector>
-#include <bitset>
-#include <queue>
+#include <cstdint>
 
 #include <spdlog/fmt/ostr.h> // must be included for printing this type with spdlog
 
+#include "game/symbol.hpp"
+
 namespace pnkd
 {
 
+// Every goal's progress code (see goal_t::progress_code()), packed into a byte each
+using goal_progress_t = std::uint64_t;
+
+inline auto progress_code(goal_progress_t const progress, std::size_t const goal) -> std::uint8_t
+{
+  return static_cast<std::uint8_t>(progress >> (8 * goal));
+}
+
+inline auto set_progress_code(goal_progress_t const progress, std::size_t const goal, std::uint8_t const code) -> goal_progress_t
+{
+  return (progress & ~(goal_progress_t{0xFF} << (8 * goal))) | (goal_progress_t{code} << (8 * goal));
+}
+
+
 struct goal_t
 {
-  static constexpr std::size_t max_goals = 5;
+  // As many as there are bytes in a goal_progress_t
+  static constexpr std::size_t max_goals = sizeof(goal_progress_t);
 
-  std::queue<std::string> m_goal = std::queue<std::string>{};
+  std::vector<std::string> m_codes = std::vector<std::string>{}; // The sequence as read from the screenshot
   std::string m_str = "";
   std::size_t m_num = 0;
-  std::size_t m_length = m_goal.size();
-  std::bitset<max_goals> m_progress = std::bitset<max_goals>{};
+  std::size_t m_length = m_codes.size();
+  symbol_seq_t m_symbols = symbol_seq_t{}; // The same sequence, interned by the puzzle_t that owns this goal
+  std::size_t m_matched = 0;
   bool m_completed = false;
   bool m_failed = false;
 
   std::size_t m_moves_taken = 0;
 
   auto empty() const -> bool;
-  auto front() const -> std::string const &;
-  auto front() -> std::string &;
+  auto front() const -> symbol_t;
   auto pop() -> void;
+  auto fail() -> void;
   auto size() const -> std::size_t;
   auto seq_len() const -> std::size_t;
   auto str() const -> std::string;
   auto moves_taken() const -> std::size_t;
   auto completed_in(std::size_t const moves_taken) -> void;
+  auto progress_code() const -> std::uint8_t;
   auto num() const -> std::size_t;
 
   template<typename OStream>
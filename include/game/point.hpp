@@ -44,6 +44,19 @@ public:
   }
 
 
+  // Width of the largest square that fits in grid_size cells, without going through floating point
+  static constexpr auto width_of(std::size_t const grid_size) -> std::size_t
+  {
+    std::size_t width = 0;
+
+    while ((width + 1) * (width + 1) <= grid_size)
+    {
+      ++width;
+    }
+
+    return width;
+  }
+
   static auto pos_to_xy(std::size_t const p, std::size_t const grid_width) -> std::pair<std::size_t, std::size_t>
   {
     if (grid_width == 0)
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "game/board.hpp"
+#include "game/goal.hpp"
+#include "game/symbol.hpp"
+
+namespace pnkd
+{
+
+// The read-only parts of a puzzle, shared by every game_state_t explored while solving it
+class puzzle_t
+{
+public:
+  using grid_t = std::vector<std::string>;
+
+  // Every cell needs a bit in a cell_mask_t, and every goal a byte of a goal_progress_t
+  static constexpr std::size_t max_grid_width = 8;
+  static constexpr std::size_t max_grid_size = max_grid_width * max_grid_width;
+  static constexpr std::size_t max_goals = goal_t::max_goals;
+
+private:
+  grid_t m_grid;
+  alphabet_t m_alphabet;
+  symbol_seq_t m_cells;
+  std::size_t m_grid_size;
+  std::size_t m_grid_width;
+  dynamic_board_t m_board;
+
+  goal_list_t m_goal_list;
+
+  std::size_t m_buffer_size;
+
+  // Random keys for hashing search states - see game_state_t::key()
+  std::vector<std::uint64_t> m_history_keys;
+  std::vector<std::uint64_t> m_position_keys;
+  std::uint64_t m_direction_key;
+  std::vector<std::vector<std::uint64_t>> m_goal_keys;
+
+  // Goal matching, compiled into a table of what each goal's progress code becomes after each symbol
+  std::vector<std::uint8_t> m_goal_lengths;
+  std::size_t m_progress_codes = 0;
+  std::vector<std::uint8_t> m_transitions;
+  goal_progress_t m_all_failed = 0;
+
+public:
+  // Throws std::invalid_argument for a grid that isn't square, or a grid or goal list bigger than the solver can represent
+  puzzle_t(grid_t const &grid, goal_list_t const &goals, std::size_t const buffer_size);
+
+  [[nodiscard]] auto grid() const -> grid_t const &;
+  [[nodiscard]] auto alphabet() const -> alphabet_t const &;
+  [[nodiscard]] auto cells() const -> symbol_seq_t const &;
+  [[nodiscard]] auto cell(std::size_t const pos) const -> symbol_t
+  {
+    return this->m_cells[pos];
+  }
+  [[nodiscard]] auto grid_size() const -> std::size_t;
+  [[nodiscard]] auto grid_width() const -> std::size_t;
+  [[nodiscard]] auto board() const -> dynamic_board_t const &
+  {
+    return this->m_board;
+  }
+  [[nodiscard]] auto line_mask(std::size_t const pos, bool const vertical) const -> cell_mask_t
+  {
+    return this->m_board.line_mask(pos, vertical);
+  }
+  [[nodiscard]] auto goals() const -> goal_list_t const &;
+  [[nodiscard]] auto buffer_size() const -> std::size_t;
+
+  [[nodiscard]] auto history_key(std::size_t const pos) const -> std::uint64_t
+  {
+    return this->m_history_keys[pos];
+  }
+  [[nodiscard]] auto position_key(std::size_t const pos) const -> std::uint64_t
+  {
+    return this->m_position_keys[pos];
+  }
+  [[nodiscard]] auto direction_key() const -> std::uint64_t
+  {
+    return this->m_direction_key;
+  }
+  [[nodiscard]] auto goal_key(std::size_t const goal, std::uint8_t const progress_code) const -> std::uint64_t
+  {
+    return this->m_goal_keys[goal][progress_code];
+  }
+
+  [[nodiscard]] auto num_goals() const -> std::size_t
+  {
+    return this->m_goal_lengths.size();
+  }
+  [[nodiscard]] auto goal_length(std::size_t const goal) const -> std::uint8_t
+  {
+    return this->m_goal_lengths[goal];
+  }
+  [[nodiscard]] auto next_progress_code(std::size_t const goal, std::uint8_t const progress_code, symbol_t const symbol) const -> std::uint8_t
+  {
+    return this->m_transitions[(((symbol * this->m_goal_lengths.size()) + goal) * this->m_progress_codes) + progress_code];
+  }
+  // A goal that needs more moves than are left in the buffer can never be completed, so it might as well have failed already
+  [[nodiscard]] auto reachable_progress_code(std::size_t const goal, std::uint8_t const progress_code, std::size_t const moves_left) const -> std::uint8_t
+  {
+    std::size_t const length = this->m_goal_lengths[goal];
+
+    return progress_code < length && length - progress_code > moves_left ? static_cast<std::uint8_t>(length + 1) : progress_code;
+  }
+  [[nodiscard]] auto all_failed() const -> goal_progress_t
+  {
+    return this->m_all_failed;
+  }
+};
+
+} // namespace pnkd
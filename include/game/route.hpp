@@ -1,5 +1,6 @@
 #pragma once
 
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -21,4 +22,8 @@ struct route_t : public std::vector<std::size_t>
   }
 };
 
+// Reads a route written out as cell numbers, either separated by commas or in the same "0 -> 5 -> 8" form str() gives.
+// Anything that isn't a cell number between them, including a minus sign, means there's no route
+auto parse_route(std::string const &text) -> std::optional<route_t>;
+
 } // namespace pnkd
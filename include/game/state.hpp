@@ -3,67 +3,143 @@
 #include <utility>
 #include <string>
 #include <vector>
-#include <bitset>
 #include <queue>
 #include <optional>
+#include <memory>
+#include <cstdint>
 
+#include "game/arena.hpp"
 #include "game/point.hpp"
 #include "game/goal.hpp"
+#include "game/puzzle.hpp"
 #include "game/route.hpp"
 
-#include "utils/uuid.hpp"
-
 namespace pnkd
 {
 
-class game_state_t
+// Everything that decides what can still happen from a state, so two states with equal keys have identical futures
+struct state_key_t
 {
-  static constexpr std::size_t max_grid_size = 36;
-  static constexpr std::size_t max_goals = 5;
+  std::uint64_t m_hash = 0;
+  std::uint64_t m_move_history = 0;
+  std::uint64_t m_progress = 0;
+  std::uint8_t m_pos = 0;
+  bool m_direction = false;
+
+  auto operator==(state_key_t const &other) const -> bool
+  {
+    return this->m_hash == other.m_hash && this->m_move_history == other.m_move_history && this->m_progress == other.m_progress && this->m_pos == other.m_pos && this->m_direction == other.m_direction;
+  }
+};
 
-  using grid_t = std::vector<std::string>;
-  using move_history_t = std::bitset<max_grid_size>;
+
+// Just enough of a state to rebuild it from, for searches that have to hold on to a lot of them at once. The puzzle comes
+// from whichever state unpacks it, and the route is left in the arena
+struct packed_state_t
+{
+  goal_progress_t m_progress = 0;
+  std::uint64_t m_completed_in = 0;
+  cell_mask_t m_move_history = 0;
+  std::uint64_t m_hash = 0;
+  state_id_t m_id = no_state;
+  std::uint8_t m_pos = 0;
+  bool m_direction = false;
+};
+
+
+class game_state_t
+{
+  using grid_t = puzzle_t::grid_t;
 
 private:
-  grid_t m_grid;
-  std::size_t m_grid_size;
-  std::size_t m_grid_width;
+  // The grid, goal definitions and buffer size never change during a solve, so every state shares them
+  std::shared_ptr<puzzle_t const> m_puzzle;
+
+  // Everything below is specific to the path taken to reach this state
+  goal_progress_t m_progress = 0;
+
+  // The move each goal was completed on, packed into a byte each like m_progress
+  std::uint64_t m_completed_in = 0;
 
-  goal_list_t m_goal_list;
+  // The cell we're on - only turned into a point_t for logging, since that needs the grid width
+  std::uint8_t m_pos = 0;
+  bool m_direction = false;
 
-  std::size_t m_buffer_size;
+  cell_mask_t m_move_history = 0;
 
-  point_t m_pos;
-  bool m_direction;
+  // Zobrist hash of the position, direction, move history and goal progress, updated incrementally by make_move()
+  std::uint64_t m_hash = 0;
 
-  move_history_t m_move_history;
+  // Successors only link back to their parent, so this stays empty until the route is rebuilt for a state worth reporting
   route_t m_route;
 
+  // Whether the search finished proving there's no better route than this one, or ran out of time first
+  bool m_proven = false;
+
+  // Only built from m_progress if someone asks for it, which the solver itself never does
+  mutable std::optional<goal_list_t> m_goal_list;
+
   bool m_complete = true;
 
-  std::string m_id = pnkd::uuid::generate();
-  std::string m_parent_id;
+  // Ids are handed out by the state_arena_t of whoever is exploring this state
+  state_id_t m_id = no_state;
+  state_id_t m_parent_id = no_state;
 
 public:
   game_state_t() = default;
   game_state_t(grid_t const &grid, goal_list_t const &goals, std::size_t const buffer_size);
-  game_state_t(grid_t const &grid, goal_list_t const &goals, std::size_t const buffer_size, point_t const &pos, bool const direction, move_history_t const &move_history, route_t const &route);
-
-  auto set_parent_id(std::string const &id) -> void;
-
-  [[nodiscard]] auto pos() const -> point_t const &;
+  explicit game_state_t(std::shared_ptr<puzzle_t const> puzzle);
+  game_state_t(std::shared_ptr<puzzle_t const> puzzle, goal_progress_t const progress, std::uint64_t const completed_in, std::size_t const pos, bool const direction, cell_mask_t const move_history, std::uint64_t const hash);
+
+  auto set_id(state_id_t const id) -> void;
+  auto set_route(route_t const &route) -> void;
+  auto set_proven(bool const proven) -> void;
+
+  [[nodiscard]] auto puzzle() const -> puzzle_t const &;
+  [[nodiscard]] auto pos() const -> point_t;
+  [[nodiscard]] auto position() const -> std::size_t;
+  [[nodiscard]] auto direction() const -> bool;
+  [[nodiscard]] auto move_history() const -> cell_mask_t;
   [[nodiscard]] auto route() const -> route_t const &;
+  [[nodiscard]] auto proven() const -> bool;
   [[nodiscard]] auto grid() const -> grid_t const &;
   [[nodiscard]] auto goals() const -> goal_list_t const &;
+  [[nodiscard]] auto is_terminal() const -> bool;
   [[nodiscard]] auto moves_taken() const -> std::size_t;
+  [[nodiscard]] auto scoring_moves() const -> std::size_t;
+  [[nodiscard]] auto goal_combo() const -> std::size_t;
+  [[nodiscard]] auto goals_completed() const -> std::size_t;
+  [[nodiscard]] auto goal_remaining(std::size_t const goal) const -> std::size_t;
   [[nodiscard]] auto buffer_size() const -> std::size_t;
-  [[nodiscard]] auto id() const -> std::string const &;
-  [[nodiscard]] auto parent_id() const -> std::string const &;
+  [[nodiscard]] auto id() const -> state_id_t;
+  [[nodiscard]] auto parent_id() const -> state_id_t;
+  [[nodiscard]] auto progress() const -> goal_progress_t;
+  [[nodiscard]] auto key() const -> state_key_t;
+  [[nodiscard]] auto pack() const -> packed_state_t;
+
+  // Rebuilds a packed state from the same puzzle as this one
+  [[nodiscard]] auto unpack(packed_state_t const &packed) const -> game_state_t;
 
   [[nodiscard]] auto is_valid_move(std::size_t const pos) const -> bool;
+  [[nodiscard]] auto valid_moves() const -> cell_mask_t;
   [[nodiscard]] auto list_all_valid_moves() const -> std::vector<std::size_t>;
   [[nodiscard]] auto make_move(std::size_t const move) const -> std::optional<game_state_t>;
-  [[nodiscard]] auto score_goals(std::size_t const move) const -> goal_list_t;
+
+  // Makes each of the moves in turn, for picking up a puzzle that's already part way through. The state it ends up in
+  // remembers the whole route so far
+  [[nodiscard]] auto replay(route_t const &moves) const -> std::optional<game_state_t>;
+
+  // The same as valid_moves(), but looking the lines up on the given board (see dispatch_board())
+  template<typename Board>
+  [[nodiscard]] auto valid_moves(Board const &board) const -> cell_mask_t
+  {
+    if (this->moves_taken() >= this->m_puzzle->buffer_size())
+    {
+      return 0;
+    }
+
+    return board.line_mask(this->m_pos, this->m_direction) & ~this->m_move_history;
+  }
 };
 
 
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace pnkd
+{
+
+// Each breach code (1C, 55, BD, E9, 7A, FF...) is interned to a one-byte id when a puzzle is built, so the solver only ever compares bytes
+using symbol_t = std::uint8_t;
+using symbol_seq_t = std::vector<symbol_t>;
+
+class alphabet_t
+{
+public:
+  static constexpr symbol_t invalid_symbol = std::numeric_limits<symbol_t>::max();
+  static constexpr std::size_t max_symbols = invalid_symbol; // The last id is reserved for codes that didn't fit
+
+private:
+  std::vector<std::string> m_codes;
+
+public:
+  alphabet_t() = default;
+
+  auto intern(std::string const &code) -> symbol_t;
+  auto intern(std::vector<std::string> const &codes) -> symbol_seq_t;
+
+  [[nodiscard]] auto find(std::string const &code) const -> symbol_t;
+  [[nodiscard]] auto code(symbol_t const symbol) const -> std::string const &;
+  [[nodiscard]] auto size() const -> std::size_t;
+};
+
+} // namespace pnkd
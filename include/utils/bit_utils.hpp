@@ -0,0 +1,30 @@
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace pnkd
+{
+
+// Index of the lowest set bit. The mask must not be zero
+inline auto count_trailing_zeros(std::uint64_t const mask) -> std::size_t
+{
+#if defined(_MSC_VER)
+  unsigned long index = 0;
+  _BitScanForward64(&index, mask);
+  return static_cast<std::size_t>(index);
+#else
+  return static_cast<std::size_t>(__builtin_ctzll(mask));
+#endif
+}
+
+inline auto count_bits(std::uint64_t const mask) -> std::size_t
+{
+  return std::bitset<64>{mask}.count();
+}
+
+} // namespace pnkd
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+
+namespace pnkd
+{
+
+// Lets one thread ask work running on another to give up. Copies share the same flag, so hand a copy to the work and
+// keep one to cancel it with. Checking it is a single relaxed load, cheap enough for the innermost loops
+class cancellation_token_t
+{
+private:
+  std::shared_ptr<std::atomic<bool>> m_cancelled = std::make_shared<std::atomic<bool>>(false);
+
+public:
+  auto cancel() const -> void
+  {
+    this->m_cancelled->store(true, std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] auto cancelled() const -> bool
+  {
+    return this->m_cancelled->load(std::memory_order_relaxed);
+  }
+};
+
+} // namespace pnkd
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <optional>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -18,6 +19,9 @@ auto strip(std::string const &input) -> std::string;
 
 auto split(std::string const &input, std::string const &delimiters = " ") -> std::vector<std::string>;
 
+// Reads a list of whole numbers separated by commas, or nothing if anything else is in the way or a number is missing
+auto parse_numbers(std::string const &input) -> std::optional<std::vector<std::size_t>>;
+
 auto grid_to_string(std::vector<std::string> const &input) -> std::string;
 auto goal_list_to_string(goal_list_t const &input) -> std::string;
 
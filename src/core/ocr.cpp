@@ -4,6 +4,7 @@
 
 #include <spdlog/spdlog.h>
 #include <tesseract/baseapi.h>
+#include <tesseract/ocrclass.h>
 #include <leptonica/allheaders.h>
 
 #include "utils/string_utils.hpp"
@@ -54,10 +55,15 @@ auto preprocess_image(cv::Mat const &raw_img, double w_scale, double x_scale, do
   return output;
 }
 
-auto get_string_from_image(cv::Mat const &img, std::string const &tessdata_path, std::string const &char_list) -> std::string
+auto get_string_from_image(cv::Mat const &img, std::string const &tessdata_path, std::string const &char_list, cancellation_token_t const &cancel) -> std::string
 {
   std::size_t constexpr bytes_per_pixel = 1; // Our preprocessed image is black and white, so only 1 byte. Set this to 3 for RGB, etc.
 
+  if (cancel.cancelled())
+  {
+    return std::string{};
+  }
+
   auto ocr = std::make_unique<tesseract::TessBaseAPI>();
   ocr->Init(tessdata_path.c_str(), "eng", tesseract::OEM_TESSERACT_ONLY); // OEM_LSTM_ONLY / OEM_TESSERACT_ONLY
 
@@ -66,6 +72,20 @@ auto get_string_from_image(cv::Mat const &img, std::string const &tessdata_path,
 
   ocr->SetVariable("tessedit_char_whitelist", char_list.c_str());
 
+  // Tesseract asks the monitor whether to carry on after every word it reads
+  auto token = cancel;
+  auto monitor = ETEXT_DESC{};
+  monitor.cancel_this = &token;
+  monitor.cancel = [](void *cancel_this, int /*words*/) { return static_cast<cancellation_token_t *>(cancel_this)->cancelled(); };
+
+  ocr->Recognize(&monitor);
+
+  if (cancel.cancelled())
+  {
+    ocr->End();
+    return std::string{};
+  }
+
   char *text = ocr->GetUTF8Text();
   auto const img_text = std::string{text};
   delete[] text; // The Tesseract API requires us to delete[] the pointer ourselves to avoid a memory leak
@@ -95,13 +115,18 @@ auto fix_ocr(std::vector<std::string> const &input) -> std::vector<std::string>
   return output;
 }
 
-auto get_grid_from_img(cv::Mat const &raw_img, std::string const &tessdata_path) -> std::vector<std::string>
+auto get_grid_from_img(cv::Mat const &raw_img, std::string const &tessdata_path, cancellation_token_t const &cancel) -> std::vector<std::string>
 {
   cv::Mat img = pnkd::preprocess_image(raw_img, 0.19, 0.16, 0.35, 0.315);
 
-  auto const grid_text = get_string_from_image(img, tessdata_path);
+  auto const grid_text = get_string_from_image(img, tessdata_path, code_characters, cancel);
+
+  // Did the OCR generate any text? (It won't have if we gave up on it)
+  if (cancel.cancelled())
+  {
+    return std::vector<std::string>{};
+  }
 
-  // Did the OCR generate any text?
   if (grid_text.empty())
   {
     spdlog::error("Failed to extract any text from grid!");
@@ -114,13 +139,18 @@ auto get_grid_from_img(cv::Mat const &raw_img, std::string const &tessdata_path)
 }
 
 
-auto get_goal_list_from_img(cv::Mat const &raw_img, std::string const &tessdata_path) -> pnkd::goal_list_t
+auto get_goal_list_from_img(cv::Mat const &raw_img, std::string const &tessdata_path, cancellation_token_t const &cancel) -> pnkd::goal_list_t
 {
   cv::Mat img = pnkd::preprocess_image(raw_img, 0.11, 0.437, 0.25, 0.3, 80);
 
-  auto const goal_text = get_string_from_image(img, tessdata_path);
+  auto const goal_text = get_string_from_image(img, tessdata_path, code_characters, cancel);
+
+  // Did the OCR generate any text? (It won't have if we gave up on it)
+  if (cancel.cancelled())
+  {
+    return pnkd::goal_list_t{};
+  }
 
-  // Did the OCR generate any text?
   if (goal_text.empty())
   {
     spdlog::error("Failed to extract any text from goals!");
@@ -135,17 +165,14 @@ auto get_goal_list_from_img(cv::Mat const &raw_img, std::string const &tessdata_
   {
     auto const segments = fix_ocr(pnkd::split(goal, " "));
 
-    auto this_goal = std::queue<std::string>{};
-
     auto tmp = std::string{};
     for (auto const &segment : segments)
     {
       tmp += segment + " ";
-      this_goal.push(segment);
     }
 
     tmp = pnkd::strip(tmp);
-    goal_list.emplace_back(pnkd::goal_t{this_goal, tmp, goal_num++});
+    goal_list.emplace_back(pnkd::goal_t{segments, tmp, goal_num++});
   }
 
   goal_list.init(); // This sets the total number of goals and the number of goals remaining from the size of the internal vector
@@ -0,0 +1,120 @@
+#include "core/oracle.hpp"
+
+#include "utils/bit_utils.hpp"
+
+namespace pnkd
+{
+
+path_oracle_t::path_oracle_t(puzzle_t const &puzzle) : m_board(puzzle.board()), m_buffer_size(puzzle.buffer_size()), m_all_cells(puzzle.board().all_cells())
+{
+  this->m_symbol_masks.resize(puzzle.alphabet().size(), 0);
+
+  for (std::size_t pos = 0; pos < puzzle.grid_size(); ++pos)
+  {
+    this->m_symbol_masks[puzzle.cell(pos)] |= cell_mask_t{1} << pos;
+  }
+}
+
+
+auto path_oracle_t::cells_matching(symbol_t const symbol) const -> cell_mask_t
+{
+  if (symbol == any_symbol)
+  {
+    return this->m_all_cells;
+  }
+
+  return symbol < this->m_symbol_masks.size() ? this->m_symbol_masks[symbol] : 0;
+}
+
+
+auto path_oracle_t::reachable(symbol_seq_t const &pattern) const -> std::vector<cell_mask_t>
+{
+  if (pattern.empty() || pattern.size() > this->m_buffer_size || this->m_board.grid_width() == 0)
+  {
+    return {};
+  }
+
+  return dispatch_board(this->m_board, [&](auto const &board) { return this->reachable_on(board, pattern); });
+}
+
+
+auto path_oracle_t::find(symbol_seq_t const &pattern) const -> std::optional<route_t>
+{
+  auto const alive = this->reachable(pattern);
+
+  if (alive.empty())
+  {
+    return std::nullopt;
+  }
+
+  return dispatch_board(this->m_board, [&](auto const &board) -> std::optional<route_t> {
+    auto route = route_t{};
+    route.reserve(pattern.size());
+
+    if (this->rebuild(board, alive, 0, 0, 0, route))
+    {
+      return route;
+    }
+
+    return std::nullopt;
+  });
+}
+
+
+template<typename Board>
+auto path_oracle_t::reachable_on(Board const &board, symbol_seq_t const &pattern) const -> std::vector<cell_mask_t>
+{
+  // The first move is always along the top row, and each move after that switches between rows and columns
+  auto const vertical = [](std::size_t const step) { return step % 2 == 1; };
+
+  // Which cells could each step of the pattern end on?
+  auto alive = std::vector<cell_mask_t>(pattern.size(), 0);
+  alive[0] = board.line_mask(0, false) & this->cells_matching(pattern[0]);
+
+  for (std::size_t step = 1; step < pattern.size() && alive[step - 1] != 0; ++step)
+  {
+    alive[step] = board.spread(alive[step - 1], vertical(step)) & this->cells_matching(pattern[step]);
+  }
+
+  if (alive.back() == 0)
+  {
+    return {};
+  }
+
+  // Now work backwards, so that only the cells that can still reach the end of the pattern are left
+  for (std::size_t step = pattern.size() - 1; step > 0; --step)
+  {
+    alive[step - 1] &= board.spread(alive[step], vertical(step));
+  }
+
+  return alive;
+}
+
+
+template<typename Board>
+auto path_oracle_t::rebuild(Board const &board, std::vector<cell_mask_t> const &alive, std::size_t const step, std::size_t const from, cell_mask_t const used, route_t &route) const -> bool
+{
+  if (step == alive.size())
+  {
+    return true;
+  }
+
+  // Cells along a row or down a column are in the same order as their bits, so trying them lowest bit first means the
+  // first route found is the same one the other solvers would report
+  for (cell_mask_t candidates = alive[step] & board.line_mask(from, step % 2 == 1) & ~used; candidates != 0; candidates &= candidates - 1)
+  {
+    std::size_t const pos = count_trailing_zeros(candidates);
+    route.push_back(pos);
+
+    if (this->rebuild(board, alive, step + 1, pos, used | (cell_mask_t{1} << pos), route))
+    {
+      return true;
+    }
+
+    route.pop_back();
+  }
+
+  return false;
+}
+
+} // namespace pnkd
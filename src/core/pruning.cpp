@@ -0,0 +1,199 @@
+#include "core/pruning.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace pnkd
+{
+
+////////////////////////////////////////////////////////////////
+// pruning_stage_t
+////////////////////////////////////////////////////////////////
+
+auto pruning_stage_t::admit(game_state_t const &game_state) -> bool
+{
+  if (this->keep(game_state))
+  {
+    return true;
+  }
+
+  ++this->m_removed;
+  return false;
+}
+
+auto pruning_stage_t::removed() const -> std::size_t
+{
+  return this->m_removed;
+}
+
+
+////////////////////////////////////////////////////////////////
+// transposition_stage_t
+////////////////////////////////////////////////////////////////
+
+transposition_stage_t::transposition_stage_t(std::size_t const max_slots) : m_max_slots(max_slots), m_table(max_slots)
+{
+}
+
+auto transposition_stage_t::keep(game_state_t const &game_state) -> bool
+{
+  return this->m_table.insert(game_state.key());
+}
+
+auto transposition_stage_t::name() const -> std::string
+{
+  return "repeated";
+}
+
+auto transposition_stage_t::fresh() const -> std::unique_ptr<pruning_stage_t>
+{
+  return std::make_unique<transposition_stage_t>(this->m_max_slots);
+}
+
+auto transposition_stage_t::reset() -> void
+{
+  this->m_table.clear();
+}
+
+auto transposition_stage_t::next_level() -> void
+{
+  // Every route to a state has the same length, so the states on the next level can only repeat each other
+  this->m_table.clear();
+}
+
+
+////////////////////////////////////////////////////////////////
+// dominance_stage_t
+////////////////////////////////////////////////////////////////
+
+dominance_stage_t::dominance_stage_t(std::size_t const max_groups) : m_max_groups(std::max(max_groups, std::size_t{1}))
+{
+  std::size_t groups = initial_groups;
+
+  // Keep the number of groups a power of two, so a hash can be turned into an index with a mask
+  while (groups > this->m_max_groups && groups > 1)
+  {
+    groups /= 2;
+  }
+
+  this->m_groups.resize(groups);
+}
+
+auto dominance_stage_t::find_group(group_key_t const &key) -> group_t &
+{
+  // Keep the table at most half full while it's allowed to grow, so probe sequences stay short
+  if (this->m_groups.size() * 2 <= this->m_max_groups && (this->m_size + 1) * 2 > this->m_groups.size())
+  {
+    this->grow();
+  }
+
+  std::size_t const mask = this->m_groups.size() - 1;
+  std::size_t const home = static_cast<std::size_t>((key.m_progress * 0x9E3779B97F4A7C15ULL) ^ (std::uint64_t{key.m_pos} << 1U) ^ std::uint64_t{key.m_direction}) & mask;
+
+  for (std::size_t probe = 0; probe < max_probes; ++probe)
+  {
+    auto &group = this->m_groups[(home + probe) & mask];
+
+    if (group.m_generation != this->m_generation)
+    {
+      group.m_key = key;
+      group.m_generation = this->m_generation;
+      group.m_count = 0;
+      ++this->m_size;
+      return group;
+    }
+
+    if (group.m_key == key)
+    {
+      return group;
+    }
+  }
+
+  // Nowhere left to put it nearby, so it replaces whatever group was in its home slot
+  auto &group = this->m_groups[home];
+  group.m_key = key;
+  group.m_count = 0;
+  return group;
+}
+
+auto dominance_stage_t::grow() -> void
+{
+  auto old_groups = std::vector<group_t>(this->m_groups.size() * 2);
+  std::swap(old_groups, this->m_groups);
+
+  this->m_size = 0;
+
+  for (auto const &old_group : old_groups)
+  {
+    if (old_group.m_generation == this->m_generation)
+    {
+      // Re-inserting can't recurse back into grow(), as the new table is at most a quarter full
+      auto &group = this->find_group(old_group.m_key);
+      group.m_count = old_group.m_count;
+      group.m_histories = old_group.m_histories;
+    }
+  }
+}
+
+auto dominance_stage_t::keep(game_state_t const &game_state) -> bool
+{
+  auto const key = game_state.key();
+  auto &group = this->find_group(group_key_t{key.m_progress, key.m_pos, key.m_direction});
+
+  auto const histories_begin = std::begin(group.m_histories);
+  auto histories_end = std::next(histories_begin, group.m_count);
+
+  std::uint64_t const history = key.m_move_history;
+
+  // Has anything in this group used only cells that this state has used too? (Then it has taken fewer moves, as well)
+  if (std::any_of(histories_begin, histories_end, [history](std::uint64_t const other) { return (other & ~history) == 0; }))
+  {
+    return false;
+  }
+
+  // This state dominates anything in the group that used all of its cells and more, so they don't need remembering
+  histories_end = std::remove_if(histories_begin, histories_end, [history](std::uint64_t const other) { return (history & ~other) == 0; });
+
+  if (histories_end == std::end(group.m_histories))
+  {
+    histories_end = std::move(std::next(histories_begin), histories_end, histories_begin);
+  }
+
+  *histories_end = history;
+  group.m_count = static_cast<std::uint32_t>(std::distance(histories_begin, histories_end) + 1);
+  return true;
+}
+
+auto dominance_stage_t::name() const -> std::string
+{
+  return "dominated";
+}
+
+auto dominance_stage_t::fresh() const -> std::unique_ptr<pruning_stage_t>
+{
+  return std::make_unique<dominance_stage_t>(this->m_max_groups);
+}
+
+auto dominance_stage_t::reset() -> void
+{
+  // Only wipe the groups for real on the rare occasion that the generation wraps around
+  if (++this->m_generation == 0)
+  {
+    std::fill(std::begin(this->m_groups), std::end(this->m_groups), group_t{});
+    this->m_generation = 1;
+  }
+
+  this->m_size = 0;
+}
+
+auto dominance_stage_t::size() const -> std::size_t
+{
+  return this->m_size;
+}
+
+auto dominance_stage_t::capacity() const -> std::size_t
+{
+  return this->m_groups.size();
+}
+
+} // namespace pnkd
@@ -1,147 +1,1384 @@
 #include "core/puzzler.hpp"
+#include "core/sequencer.hpp"
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstdint>
 #include <bitset>
 #include <numeric>
 #include <sstream>
 #include <utility>
 #include <map>
+#include <thread>
 
 #include <spdlog/spdlog.h>
 
+#include "game/board.hpp"
 #include "game/goal.hpp"
 #include "game/point.hpp"
 #include "game/state.hpp"
 
+#include "utils/bit_utils.hpp"
 #include "utils/string_utils.hpp"
 
 namespace pnkd
 {
 
 
-puzzler::puzzler(game_state_t const &game_state)
+auto parse_search_strategy(std::string const &name) -> std::optional<search_strategy_t>
 {
+  if (name == "bfs")
+  {
+    return search_strategy_t::breadth_first;
+  } else if (name == "dfs")
+  {
+    return search_strategy_t::depth_first;
+  } else if (name == "best")
+  {
+    return search_strategy_t::best_first;
+  } else if (name == "seq")
+  {
+    return search_strategy_t::sequence_first;
+  } else if (name == "beam")
+  {
+    return search_strategy_t::beam;
+  }
+
+  return std::nullopt;
+}
+
+
+auto remove_dominated(std::map<std::size_t, game_state_t> &solutions) -> void
+{
+  // A route isn't worth reporting if another one completes all of the same goals (and more) in as few moves
+  for (auto it = std::begin(solutions); it != std::end(solutions);)
+  {
+    auto const &[combo, solution] = *it;
+
+    bool const dominated = std::any_of(std::begin(solutions), std::end(solutions), [&](auto const &other) {
+      return other.first != combo && (other.first & combo) == combo && other.second.scoring_moves() <= solution.scoring_moves();
+    });
+
+    it = dominated ? solutions.erase(it) : std::next(it);
+  }
+}
+
+
+auto goal_weights_by_order(std::size_t const num_goals) -> std::vector<std::size_t>
+{
+  auto weights = std::vector<std::size_t>(num_goals);
+  std::iota(std::begin(weights), std::end(weights), std::size_t{1});
+
+  return weights;
+}
+
+
+auto beats(game_state_t const &candidate, route_t const &route, game_state_t const &incumbent) -> bool
+{
+  // Fewest moves wins, then whichever route comes first
+  return candidate.scoring_moves() < incumbent.scoring_moves() || (candidate.scoring_moves() == incumbent.scoring_moves() && route < incumbent.route());
+}
+
+
+auto measure_quality_gap(std::map<std::size_t, game_state_t> const &optimal, std::map<std::size_t, game_state_t> const &approximate) -> quality_gap_t
+{
+  auto gap = quality_gap_t{};
+  std::size_t optimal_goals = 0;
+  std::size_t approximate_goals = 0;
+
+  for (auto const &[combo, solution] : approximate)
+  {
+    approximate_goals = std::max(approximate_goals, solution.goals_completed());
+  }
+
+  for (auto const &[combo, solution] : optimal)
+  {
+    ++gap.m_combos;
+    optimal_goals = std::max(optimal_goals, solution.goals_completed());
+
+    // A route that completes more goals than these still completes these
+    auto fewest_moves = std::optional<std::size_t>{};
+
+    for (auto const &[approximate_combo, approximate_solution] : approximate)
+    {
+      if ((approximate_combo & combo) == combo)
+      {
+        fewest_moves = std::min(fewest_moves.value_or(approximate_solution.scoring_moves()), approximate_solution.scoring_moves());
+      }
+    }
+
+    if (!fewest_moves)
+    {
+      ++gap.m_missed;
+    } else if (fewest_moves.value() <= solution.scoring_moves())
+    {
+      ++gap.m_optimal;
+    } else
+    {
+      gap.m_extra_moves += fewest_moves.value() - solution.scoring_moves();
+    }
+  }
+
+  gap.m_goals_missed = optimal_goals - std::min(optimal_goals, approximate_goals);
+
+  return gap;
+}
+
+
+namespace
+{
+
+// Other threads might be lowering the same value, so only swap ours in if it's still lower than theirs
+auto lower_to(std::atomic<std::size_t> &value, std::size_t const to) -> void
+{
+  std::size_t current = value.load(std::memory_order_relaxed);
+
+  while (to < current && !value.compare_exchange_weak(current, to, std::memory_order_relaxed))
+  {
+  }
+}
+
+
+// Same again, but for a value that only ever goes up
+auto raise_to(std::atomic<std::uint64_t> &value, std::uint64_t const to) -> void
+{
+  std::uint64_t current = value.load(std::memory_order_relaxed);
+
+  while (to > current && !value.compare_exchange_weak(current, to, std::memory_order_relaxed))
+  {
+  }
+}
+
+
+// Packs "worth more, then fewer moves" into one number so it can be compared (and raised) in one go. Routes are never
+// anywhere near 256 moves long
+auto weighted_score(std::size_t const weight, std::size_t const moves) -> std::uint64_t
+{
+  return (std::uint64_t{weight} << 8U) | (0xFFU - moves);
+}
+
+} // namespace
+
+
+puzzler::puzzler(game_state_t const &game_state, search_strategy_t const strategy, std::size_t const threads)
+  : m_strategy(strategy), m_threads(std::max(threads, std::size_t{1})), m_candidates(std::size_t{1} << game_state.puzzle().num_goals()), m_bounds(std::size_t{1} << game_state.puzzle().num_goals())
+{
+  this->m_workers.push_back(std::make_unique<search_worker_t>());
+
+  // The sequencer can only spell routes out from an empty buffer, so a puzzle that's part way through gets searched instead
+  if (strategy == search_strategy_t::sequence_first && game_state.moves_taken() != 0)
+  {
+    spdlog::info("Searching depth-first, since the sequencer can't pick up a puzzle part way through");
+    this->m_strategy = search_strategy_t::depth_first;
+  }
+
+  // The beam search would only be slowed down by handing states between threads, since it has to finish each depth before
+  // it can pick the best of the next
+  if (this->m_strategy == search_strategy_t::beam && this->m_threads > 1)
+  {
+    spdlog::info("Searching on one thread, since the beam search can't be split up between threads");
+    this->m_threads = 1;
+  }
+
+  // Cheapest first - an exact repeat is also dominated, but it's quicker to spot
+  bool const depth_first = this->m_strategy == search_strategy_t::depth_first || this->m_strategy == search_strategy_t::best_first || this->m_threads > 1;
+  this->add_pruning_stage(std::make_unique<transposition_stage_t>(depth_first ? depth_first_table_slots : 0));
+  this->add_pruning_stage(std::make_unique<dominance_stage_t>());
+
+  auto root = game_state;
+  root.set_id(this->m_arena.add(no_state, 0));
+
   auto q = std::queue<game_state_t>{};
-  q.push(game_state);
+  q.push(root);
   this->m_game_states = q;
-  this->m_total_goals = game_state.goals().total();
+  this->m_total_goals = game_state.puzzle().num_goals();
+  this->m_prefix = game_state.route();
+
+  // Nothing has been found yet, so every combination of goals is still up for grabs
+  for (auto &bound : this->m_bounds)
+  {
+    bound.store(no_bound, std::memory_order_relaxed);
+  }
+}
+
+
+auto puzzler::add_pruning_stage(std::unique_ptr<pruning_stage_t> stage) -> void
+{
+  this->m_workers.front()->m_pruning_stages.push_back(std::move(stage));
+}
+
+
+auto puzzler::clear_pruning_stages() -> void
+{
+  this->m_workers.front()->m_pruning_stages.clear();
+}
+
+
+auto puzzler::on_progress(progress_callback_t callback) -> void
+{
+  this->m_on_progress = std::move(callback);
+}
+
+
+auto puzzler::set_beam_width(std::size_t const width) -> void
+{
+  this->m_beam_width = std::max(width, std::size_t{1});
+}
+
+
+auto puzzler::stopping(std::size_t const states_explored) -> bool
+{
+  if (this->m_stopping.load(std::memory_order_relaxed))
+  {
+    return true;
+  }
+
+  // Reading the clock costs more than exploring a state, so only look every so often
+  if (states_explored % states_per_clock_check != 0)
+  {
+    return false;
+  }
+
+  if (!this->m_cancel.cancelled() && (!this->m_deadline || std::chrono::steady_clock::now() < this->m_deadline.value()))
+  {
+    return false;
+  }
+
+  this->m_stopping.store(true, std::memory_order_relaxed);
+
+  return true;
+}
+
+
+auto puzzler::stop_unexplored(std::size_t const moves_taken) -> void
+{
+  lower_to(this->m_unexplored_moves, moves_taken);
+}
+
+
+auto puzzler::publish(game_state_t const &candidate, route_t const &route) -> void
+{
+  if (!this->m_on_progress)
+  {
+    return;
+  }
+
+  auto const lock = std::lock_guard{this->m_progress_mutex};
+
+  auto const goal_combo = candidate.goal_combo();
+  auto const it = this->m_progress.find(goal_combo);
+  auto const whole_route = this->full_route(route);
+
+  if (it != std::end(this->m_progress) && !beats(candidate, whole_route, it->second))
+  {
+    return;
+  }
+
+  auto state = candidate;
+  state.set_route(whole_route);
+  this->m_progress[goal_combo] = state;
+
+  this->m_on_progress(this->m_progress);
+}
+
+
+auto puzzler::full_route(route_t const &route) const -> route_t
+{
+  if (this->m_prefix.empty())
+  {
+    return route;
+  }
+
+  auto whole_route = this->m_prefix;
+  whole_route.insert(std::end(whole_route), std::begin(route), std::end(route));
+
+  return whole_route;
+}
+
+
+auto puzzler::is_proven(game_state_t const &solution) const -> bool
+{
+  // Nothing is left unexplored unless the search stopped early, or the beam search left it behind
+  return solution.scoring_moves() <= this->m_unexplored_moves.load(std::memory_order_relaxed);
+}
+
+
+auto puzzler::mark_proven(std::map<std::size_t, game_state_t> &solutions) const -> void
+{
+  std::size_t proven = 0;
+
+  for (auto &[combo, solution] : solutions)
+  {
+    solution.set_proven(this->is_proven(solution));
+    proven += solution.proven() ? 1 : 0;
+  }
+
+  if (this->m_stopping)
+  {
+    spdlog::warn("{}, so only {} of {} solution(s) are proven optimal", this->m_cancel.cancelled() ? "Cancelled" : "Ran out of time", proven, solutions.size());
+  } else if (proven < solutions.size())
+  {
+    spdlog::warn("The beam was too narrow to keep every state, so only {} of {} solution(s) are proven optimal", proven, solutions.size());
+  }
+}
+
+
+auto puzzler::admit(search_worker_t &worker, game_state_t const &game_state) -> bool
+{
+  return std::all_of(std::begin(worker.m_pruning_stages), std::end(worker.m_pruning_stages), [&game_state](auto const &stage) { return stage->admit(game_state); });
+}
+
+
+auto puzzler::pruning_summary() const -> std::string
+{
+  auto summary = std::stringstream{};
+  auto const &stages = this->m_workers.front()->m_pruning_stages;
+
+  for (std::size_t i = 0; i < stages.size(); ++i)
+  {
+    // Every worker has its own copy of each stage, so add them all up
+    std::size_t const removed = std::accumulate(std::begin(this->m_workers), std::end(this->m_workers), std::size_t{0}, [i](std::size_t const total, auto const &worker) { return total + worker->m_pruning_stages[i]->removed(); });
+
+    summary << (summary.tellp() > 0 ? ", " : "") << removed << " " << stages[i]->name();
+  }
+
+  return summary.str();
 }
 
 
 auto puzzler::calculate_all_routes() -> void
+{
+  auto const &puzzle = this->m_game_states.front().puzzle();
+
+  dispatch_board(puzzle.board(), [this](auto const &board) { this->search_breadth_first(board); });
+}
+
+
+template<typename Board>
+auto puzzler::search_breadth_first(Board const &board) -> void
 {
   int iters = 0;
+  std::size_t depth = 0;
 
   while (!this->m_game_states.empty() && this->should_continue)
   {
     spdlog::debug("\n----------------------\nIteration {}\n----------------------", iters++);
 
+    // The queue is in order of moves taken, so the front of it has the fewest of anything left
+    if (this->stopping(static_cast<std::size_t>(iters)))
+    {
+      this->stop_unexplored(this->m_game_states.front().moves_taken());
+      break;
+    }
+
     // Get the state at the front of the queue
     auto game_state = this->m_game_states.front();
-    spdlog::debug("Evaluating state id {} (parent {})", game_state.id(), game_state.parent_id());
+    spdlog::debug("Evaluating state #{} (parent #{})", game_state.id(), game_state.parent_id());
 
-    // Have we taken all our moves in this state?
-    if (game_state.moves_taken() >= game_state.buffer_size())
+    // Have we just started on the next level of the tree? If nothing at this depth can beat what we've already found, then we're done
+    if (game_state.moves_taken() > depth)
     {
-      // Add it to the list of candidates if we've scored any goals
-      if (game_state.goals().completed() > 0)
+      depth = game_state.moves_taken();
+      this->should_continue = this->can_improve_after(depth);
+
+      if (!this->should_continue)
       {
-        this->m_candidates.push_back(game_state);
+        spdlog::debug("Nothing after {} moves can improve on the current solutions, so stopping early", depth);
+        break;
       }
 
-    } else
+      // Some pruning stages only need to remember the level they're on
+      for (auto &stage : this->m_workers.front()->m_pruning_stages)
+      {
+        stage->next_level();
+      }
+    }
+
+    // Only expand states that still have something to play for
+    if (game_state.moves_taken() < game_state.buffer_size() && this->can_improve(game_state))
     {
-      // List all the valid moves we could make
-      std::vector<std::size_t> const valid_moves = game_state.list_all_valid_moves();
-      spdlog::debug("Found {} valid moves from {} @ {}", valid_moves.size(), game_state.grid()[game_state.pos().pos()], game_state.pos());
+      // Find all the valid moves we could make
+      cell_mask_t const valid_moves = game_state.valid_moves(board);
+      spdlog::debug("Found {} valid moves from {} @ {}", count_bits(valid_moves), game_state.grid()[game_state.position()], game_state.pos());
 
-      // Play each move out
-      for (std::size_t const move : valid_moves)
+      // Play each move out, lowest cell first
+      for (cell_mask_t moves = valid_moves; moves != 0; moves &= moves - 1)
       {
+        std::size_t const move = count_trailing_zeros(moves);
         spdlog::debug("++++++++++++++++++++++");
 
         // Make the move and score the goals
         auto next_game_state = game_state.make_move(move);
 
-        if (next_game_state)
+        if (!next_game_state)
+        {
+          continue;
+        }
+
+        // Did the move complete any goals? If so, it's a candidate - the player can stop here, so any further moves aren't part of its score
+        bool const completed_more = next_game_state->goal_combo() != game_state.goal_combo();
+
+        // Once every goal is either completed or failed there's nothing left to search, so only a new candidate is worth keeping.
+        // Otherwise, has a different route already reached this state, or one at least as good? It got there first, so it has the better route
+        bool const terminal = next_game_state->is_terminal();
+
+        if (terminal ? !completed_more : !this->admit(*this->m_workers.front(), next_game_state.value()))
+        {
+          continue;
+        }
+
+        next_game_state->set_id(this->m_arena.add(next_game_state->parent_id(), move));
+
+        if (!terminal)
         {
-          next_game_state->set_parent_id(game_state.id());
           this->m_game_states.push(next_game_state.value());
+        }
 
-          // Was the move worth adding to the list of candidates?
-          if (next_game_state->goals().remaining() == 0 && next_game_state->goals().completed() > 0)
-          {
-            spdlog::debug("Candidate: {} of {} goals in {} moves", next_game_state->goals().completed(), next_game_state->goals().total(), next_game_state->moves_taken());
+        if (completed_more)
+        {
+          spdlog::debug("Candidate: {} of {} goals in {} moves", next_game_state->goals_completed(), this->m_total_goals, next_game_state->moves_taken());
 
-            this->m_candidates.push_back(next_game_state.value());
-          }
+          this->record_candidate(next_game_state.value());
         }
       }
     }
 
     // Pop this state now that we've dealt with it
     this->m_game_states.pop();
+  }
+}
+
+auto puzzler::record_candidate(game_state_t const &candidate) -> void
+{
+  ++this->m_candidates_found;
+
+  std::size_t const goal_combo = candidate.goal_combo();
+  std::size_t const scoring_moves = candidate.scoring_moves();
+  auto &best = this->m_candidates[goal_combo];
+
+  // Keep the first candidate for each combination, unless a later one needs fewer moves (the search goes level by level,
+  // so that's rare)
+  if (!best || scoring_moves < best->m_scoring_moves)
+  {
+    best = candidate_t{candidate, scoring_moves};
+    this->tighten_bounds(goal_combo, scoring_moves);
 
-    // TODO: Check if it's now impossible to improve on the current solutions, and toggle this->should_continue to cancel further loops
+    if (this->m_on_progress)
+    {
+      this->publish(candidate, this->m_arena.route(candidate.id()));
+    }
   }
 }
 
+
 auto puzzler::pick_best_routes() -> std::map<std::size_t, game_state_t>
 {
   auto optimal_solutions = std::map<std::size_t, game_state_t>{};
 
-  spdlog::info("Generated {} candidate routes", this->m_candidates.size());
-  for (auto const &candidate : this->m_candidates)
+  spdlog::info("Generated {} candidate routes ({})", this->m_candidates_found, this->pruning_summary());
+
+  for (std::size_t goal_combo = 0; goal_combo < this->m_candidates.size(); ++goal_combo)
+  {
+    if (this->m_candidates[goal_combo])
+    {
+      optimal_solutions[goal_combo] = this->m_candidates[goal_combo]->m_state;
+    }
+  }
+
+  // Only now that we know which states are worth reporting do we need to rebuild their routes
+  for (auto &[combo, solution] : optimal_solutions)
+  {
+    solution.set_route(this->m_arena.route(solution.id()));
+  }
+
+  spdlog::info("Refined {} candidates down to {} optimal solution(s)", this->m_candidates_found, optimal_solutions.size());
+
+  return optimal_solutions;
+}
+
+
+auto puzzler::tighten_bounds(std::size_t const goal_combo, std::size_t const scoring_moves) -> void
+{
+  // Only for exactly these goals - a route that completes more of them is still no substitute for the best route to these
+  lower_to(this->m_bounds[goal_combo], scoring_moves);
+}
+
+
+auto puzzler::can_improve(game_state_t const &game_state) const -> bool
+{
+  std::size_t const completed = game_state.goal_combo();
+  std::size_t const moves_taken = game_state.moves_taken();
+  std::size_t const moves_left = game_state.buffer_size() - moves_taken;
+
+  // Which goals could still be completed in the moves we have left, and the soonest each of them could be. Even if every
+  // move from here on progresses a goal, it can't be done any sooner than that
+  std::uint8_t live_goals = 0;
+  auto soonest = std::array<std::size_t, goal_t::max_goals>{};
+
+  for (std::size_t i = 0; i < this->m_total_goals; ++i)
   {
-    auto gb = std::bitset<goal_t::max_goals>{};
+    std::size_t const remaining = game_state.goal_remaining(i);
 
-    // Score each candidate - longer goal sequences and fewer moves are better
-    auto const &goals = candidate.goals();
+    if (remaining != 0 && remaining <= moves_left)
+    {
+      live_goals |= static_cast<std::uint8_t>(1U << i);
+      soonest[i] = moves_taken + remaining;
+    }
+  }
+
+  // The latest of the soonest times of every goal in the subset
+  auto const best_case = [this, &soonest](std::uint8_t const subset) {
+    std::size_t latest = 0;
 
-    for (std::size_t i = 0; i < goals.total(); ++i)
+    for (std::size_t i = 0; i < this->m_total_goals; ++i)
     {
-      if (goals[i].m_completed)
+      if ((subset >> i) & 1U)
       {
-        gb.set(i);
+        latest = std::max(latest, soonest[i]);
       }
     }
 
-    //spdlog::debug("{} - {} of {} goals in {} moves: {}", candidate.id(), candidate.goals().completed(), candidate.goals().total(), candidate.moves_taken(), candidate.route());
+    return latest;
+  };
 
-    auto goal_combo = static_cast<std::size_t>(gb.to_ulong());
+  // Every goal is worth something, so the most we could hope for is completing all the live ones. Could that be worth more
+  // than the best route so far, or as much in fewer moves?
+  if (!this->m_combo_weights.empty())
+  {
+    std::uint64_t const score = weighted_score(this->m_combo_weights[completed | live_goals], best_case(live_goals));
+    std::uint64_t const incumbent = this->m_incumbent.load(std::memory_order_relaxed);
 
-    // Is this the first example of this combo of completed goals?
-    if (optimal_solutions.find(goal_combo) == std::end(optimal_solutions))
-    {
-      optimal_solutions[goal_combo] = candidate;
-    } else
-    {
-      // If not, check if this candidate is better than the previous best
-      auto const current_best = optimal_solutions.at(goal_combo);
-      std::size_t curr_best_scoring_moves = std::max_element(std::begin(current_best.goals()), std::end(current_best.goals()), [](auto const &lhs, auto const &rhs) { return lhs.moves_taken() < rhs.moves_taken(); })->moves_taken();
-      std::size_t candidate_scoring_moves = std::max_element(std::begin(candidate.goals()), std::end(candidate.goals()), [](auto const &lhs, auto const &rhs) { return lhs.moves_taken() < rhs.moves_taken(); })->moves_taken();
+    return live_goals != 0 && (score > incumbent || (this->m_keep_ties && score == incumbent));
+  }
 
-      //spdlog::debug("This candidate scored it's {} goal(s) in {} moves: {} (full route: {})", candidate.goals().completed(), candidate_scoring_moves, candidate.route().first_n(candidate_scoring_moves), candidate.route());
+  // Try every combination of the live goals being completed on top of the ones we already have
+  for (std::uint8_t subset = live_goals; subset != 0; subset = static_cast<std::uint8_t>((subset - 1) & live_goals))
+  {
+    // Could this beat every route we already have that completes (at least) these goals?
+    std::size_t const moves = best_case(subset);
+    std::size_t const bound = this->m_bounds[completed | subset].load(std::memory_order_relaxed);
 
-      //if (candidate.moves_taken() < current_best.moves_taken())
-      if (candidate_scoring_moves < curr_best_scoring_moves)
-      {
-        optimal_solutions[goal_combo] = candidate;
-      }
+    if (moves < bound || (this->m_keep_ties && moves == bound))
+    {
+      return true;
     }
   }
 
-  spdlog::info("Refined {} candidates down to {} optimal solution(s)", this->m_candidates.size(), optimal_solutions.size());
+  return false;
+}
+
 
-  return optimal_solutions;
+auto puzzler::can_improve_after(std::size_t const moves_taken) const -> bool
+{
+  // The soonest any state with this many moves behind it could complete anything is on its next move
+  return std::any_of(std::next(std::begin(this->m_bounds)), std::end(this->m_bounds), [moves_taken](auto const &bound) { return bound.load(std::memory_order_relaxed) > moves_taken + 1; });
+}
+
+
+auto puzzler::optimistic_goals(game_state_t const &game_state) const -> std::size_t
+{
+  // Every goal we already have, plus every one that still fits in the moves left
+  std::size_t const moves_left = game_state.buffer_size() - game_state.moves_taken();
+  std::size_t goals = game_state.goals_completed();
+
+  for (std::size_t i = 0; i < this->m_total_goals; ++i)
+  {
+    std::size_t const remaining = game_state.goal_remaining(i);
+
+    if (remaining != 0 && remaining <= moves_left)
+    {
+      ++goals;
+    }
+  }
+
+  return goals;
 }
 
 
-auto puzzler::solve() -> std::map<std::size_t, game_state_t>
+auto puzzler::beam_entry(game_state_t const &state) const -> beam_entry_t
 {
-  this->calculate_all_routes();
+  // How many codes have been matched towards the goals that are still in reach
+  std::size_t const moves_left = state.buffer_size() - state.moves_taken();
+  std::size_t progress = 0;
+
+  for (std::size_t i = 0; i < this->m_total_goals; ++i)
+  {
+    std::size_t const remaining = state.goal_remaining(i);
+
+    if (remaining != 0 && remaining <= moves_left)
+    {
+      progress += state.puzzle().goal_length(i) - remaining;
+    }
+  }
+
+  std::size_t const completed = state.goals_completed();
+  std::size_t const reachable = this->optimistic_goals(state);
+
+  return beam_entry_t{state.pack(), static_cast<std::uint8_t>(completed), static_cast<std::uint8_t>(reachable), static_cast<std::uint8_t>(progress)};
+}
+
+
+auto puzzler::record_best(std::map<std::size_t, game_state_t> &best, game_state_t const &candidate, route_t const &route) -> void
+{
+  auto const goal_combo = candidate.goal_combo();
+  auto const it = best.find(goal_combo);
+
+  // Keep the first route we find for each combination, unless a later one needs fewer moves. Parallel workers don't
+  // finish in search order, so on a tie the route that comes first in that order wins
+  if (it == std::end(best) || beats(candidate, route, it->second))
+  {
+    spdlog::debug("New best: {} of {} goals in {} moves", candidate.goals_completed(), this->m_total_goals, candidate.scoring_moves());
+
+    auto state = candidate;
+    state.set_route(route);
+    best[goal_combo] = state;
+
+    // When keeping alternatives, the bounds come from those instead
+    if (this->m_alternatives == 1)
+    {
+      this->tighten_bounds(goal_combo, candidate.scoring_moves());
+    }
+
+    this->publish(candidate, route);
+  }
+}
+
+
+auto puzzler::record_alternative(std::vector<game_state_t> &alternatives, game_state_t const &candidate, route_t const &route) -> void
+{
+  // Ordered so that the heap puts the worst route first, ready to be replaced
+  auto const better = [](game_state_t const &lhs, game_state_t const &rhs) { return beats(lhs, lhs.route(), rhs); };
+
+  if (alternatives.size() == this->m_alternatives)
+  {
+    if (!beats(candidate, route, alternatives.front()))
+    {
+      return;
+    }
+
+    std::pop_heap(std::begin(alternatives), std::end(alternatives), better);
+    alternatives.pop_back();
+  }
+
+  auto state = candidate;
+  state.set_route(route);
+  alternatives.push_back(state);
+  std::push_heap(std::begin(alternatives), std::end(alternatives), better);
+
+  // Once there are enough, anything that can't beat the worst of them isn't worth looking for
+  if (alternatives.size() == this->m_alternatives)
+  {
+    lower_to(this->m_bounds[candidate.goal_combo()], alternatives.front().scoring_moves());
+  }
+}
+
+
+auto puzzler::record(search_worker_t &worker, game_state_t const &candidate, route_t const &route) -> void
+{
+  this->record_best(worker.m_best, candidate, route);
+
+  if (!this->m_combo_weights.empty())
+  {
+    raise_to(this->m_incumbent, weighted_score(this->m_combo_weights[candidate.goal_combo()], candidate.scoring_moves()));
+  }
+
+  if (this->m_alternatives > 1)
+  {
+    this->record_alternative(worker.m_alternatives[candidate.goal_combo()], candidate, route);
+  }
+}
+
+
+auto puzzler::search_subtree(search_worker_t &worker, game_state_t const &game_state, route_t &route) -> void
+{
+  dispatch_board(game_state.puzzle().board(), [&](auto const &board) { this->search_depth_first(board, worker, game_state, route); });
+}
+
+
+template<typename Board>
+auto puzzler::search_depth_first(Board const &board, search_worker_t &worker, game_state_t const &game_state, route_t &route) -> void
+{
+  ++worker.m_states_explored;
+
+  if (this->stopping(worker.m_states_explored))
+  {
+    this->stop_unexplored(game_state.moves_taken());
+    return;
+  }
+
+  // Don't go any deeper if we're out of moves, or if nothing down here can beat the routes we already have
+  if (game_state.moves_taken() >= game_state.buffer_size() || !this->can_improve(game_state))
+  {
+    ++worker.m_states_pruned;
+    return;
+  }
+
+  // In parallel, there's a task for each first move, and after that subtrees are only handed out while someone is waiting for work
+  bool const share = this->m_threads > 1 && (game_state.moves_taken() == 0 || (this->m_workers_idle.load(std::memory_order_relaxed) > 0 && game_state.buffer_size() - game_state.moves_taken() > min_moves_to_share));
+
+  for (cell_mask_t moves = game_state.valid_moves(board); moves != 0; moves &= moves - 1)
+  {
+    std::size_t const move = count_trailing_zeros(moves);
+    auto next_game_state = game_state.make_move(move);
+
+    if (!next_game_state)
+    {
+      continue;
+    }
+
+    // Once every goal is either completed or failed there's nothing below this move to search, so all that matters is
+    // whether it completed anything
+    if (next_game_state->is_terminal())
+    {
+      if (next_game_state->goal_combo() != game_state.goal_combo())
+      {
+        route.push_back(move);
+        this->record(worker, next_game_state.value(), route);
+        route.pop_back();
+      }
+
+      continue;
+    }
+
+    // If we've already been here (or somewhere at least as good) by a different route, everything below it has already been explored
+    if (this->admit(worker, next_game_state.value()))
+    {
+      route.push_back(move);
+
+      // Did the move complete any goals?
+      if (next_game_state->goal_combo() != game_state.goal_combo())
+      {
+        this->record(worker, next_game_state.value(), route);
+      }
+
+      if (share)
+      {
+        this->share_task(worker, search_task_t{next_game_state.value(), route});
+      } else
+      {
+        this->search_depth_first(board, worker, next_game_state.value(), route);
+      }
+
+      route.pop_back();
+    }
+  }
+}
+
+
+auto puzzler::take_task(std::size_t const worker_num) -> std::optional<search_task_t>
+{
+  // Our own most recent task first, then the oldest task of whoever's next in line
+  for (std::size_t i = 0; i < this->m_workers.size(); ++i)
+  {
+    auto &worker = *this->m_workers[(worker_num + i) % this->m_workers.size()];
+    auto const lock = std::lock_guard{worker.m_tasks_mutex};
+
+    if (!worker.m_tasks.empty())
+    {
+      auto task = std::optional<search_task_t>{};
+
+      if (i == 0)
+      {
+        task = std::move(worker.m_tasks.back());
+        worker.m_tasks.pop_back();
+      } else
+      {
+        task = std::move(worker.m_tasks.front());
+        worker.m_tasks.pop_front();
+      }
+
+      return task;
+    }
+  }
+
+  return std::nullopt;
+}
+
+
+auto puzzler::share_task(search_worker_t &worker, search_task_t task) -> void
+{
+  ++this->m_tasks_pending;
+
+  {
+    auto const lock = std::lock_guard{worker.m_tasks_mutex};
+    worker.m_tasks.push_back(std::move(task));
+  }
+
+  {
+    auto const lock = std::lock_guard{this->m_idle_mutex};
+    ++this->m_tasks_shared;
+  }
+
+  this->m_work_available.notify_one();
+}
+
+
+auto puzzler::run_worker(std::size_t const worker_num) -> void
+{
+  auto &worker = *this->m_workers[worker_num];
+  bool idle = false;
+
+  while (true)
+  {
+    // Anything shared after this is noticed by the wait below, even if it was missed by take_task()
+    std::size_t tasks_shared = 0;
+
+    {
+      auto const lock = std::lock_guard{this->m_idle_mutex};
+      tasks_shared = this->m_tasks_shared;
+    }
+
+    auto task = this->take_task(worker_num);
+
+    if (!task)
+    {
+      if (!idle)
+      {
+        idle = true;
+        ++this->m_workers_idle;
+      }
+
+      // Once nobody has a task left (or is running one that could hand out more), we're done. Until then, sleep until
+      // there might be something to steal
+      auto lock = std::unique_lock{this->m_idle_mutex};
+      this->m_work_available.wait(lock, [this, tasks_shared]() { return this->m_tasks_pending == 0 || this->m_tasks_shared != tasks_shared; });
+
+      if (this->m_tasks_pending == 0)
+      {
+        break;
+      }
+
+      continue;
+    }
+
+    if (idle)
+    {
+      idle = false;
+      --this->m_workers_idle;
+    }
+
+    // Start every task with a clean slate, so which states it skips doesn't depend on what this worker happened to run before
+    for (auto &stage : worker.m_pruning_stages)
+    {
+      stage->reset();
+    }
+
+    this->search_subtree(worker, task->m_state, task->m_route);
+
+    // The last task to finish wakes everyone up to leave. Passing through the lock first means nobody can be between
+    // checking for tasks and going to sleep when the notification goes out
+    if (--this->m_tasks_pending == 0)
+    {
+      this->m_idle_mutex.lock();
+      this->m_idle_mutex.unlock();
+      this->m_work_available.notify_all();
+    }
+  }
+
+  if (idle)
+  {
+    --this->m_workers_idle;
+  }
+}
+
+
+auto puzzler::branch_and_bound() -> std::map<std::size_t, game_state_t>
+{
+  auto &worker = *this->m_workers.front();
+
+  // The depth-first search only ever needs the current path, so it starts from the root rather than the queue
+  auto const root = this->m_game_states.front();
+  auto route = route_t{};
+  route.reserve(root.buffer_size());
+
+  this->search_subtree(worker, root, route);
+
+  spdlog::info("Explored {} states ({} pruned, {}) to find {} optimal solution(s)", worker.m_states_explored, worker.m_states_pruned, this->pruning_summary(), worker.m_best.size());
+
+  return worker.m_best;
+}
+
+
+template<typename Board>
+auto puzzler::search_best_first(Board const &board) -> void
+{
+  auto &worker = *this->m_workers.front();
+
+  // The heap puts the greatest entry first - the most goals, then the fewest moves, then whichever route comes first
+  auto const less_promising = [this](frontier_entry_t const &lhs, frontier_entry_t const &rhs) {
+    if (lhs.m_estimate != rhs.m_estimate)
+    {
+      return lhs.m_estimate < rhs.m_estimate;
+    }
+
+    if (lhs.m_moves_taken != rhs.m_moves_taken)
+    {
+      return lhs.m_moves_taken > rhs.m_moves_taken;
+    }
+
+    return this->m_arena.route_before(rhs.m_state.m_id, lhs.m_state.m_id);
+  };
+
+  // A heap rather than a std::priority_queue, so that entries can be moved out of it
+  auto frontier = std::vector<frontier_entry_t>{};
+  auto const root = this->m_game_states.front();
+  frontier.push_back(frontier_entry_t{root.pack(), static_cast<std::uint8_t>(this->optimistic_goals(root)), 0});
+
+  while (!frontier.empty())
+  {
+    std::pop_heap(std::begin(frontier), std::end(frontier), less_promising);
+    auto const entry = frontier.back();
+    frontier.pop_back();
+
+    auto const game_state = root.unpack(entry.m_state);
+    ++worker.m_states_explored;
+
+    if (this->stopping(worker.m_states_explored))
+    {
+      this->stop_unexplored(entry.m_moves_taken);
+
+      for (auto const &unexplored : frontier)
+      {
+        this->stop_unexplored(unexplored.m_moves_taken);
+      }
+
+      break;
+    }
+
+    // The bounds might have come down since this was queued
+    if (!this->can_improve(game_state))
+    {
+      ++worker.m_states_pruned;
+      continue;
+    }
+
+    // States are only checked for repeats once they come off the heap, because that's the order their routes are in. If
+    // the pruning stages saw them as they were queued, a later route could get in ahead of an earlier one
+    if (!this->admit(worker, game_state))
+    {
+      continue;
+    }
+
+    for (cell_mask_t moves = game_state.valid_moves(board); moves != 0; moves &= moves - 1)
+    {
+      std::size_t const move = count_trailing_zeros(moves);
+      auto next_game_state = game_state.make_move(move);
+
+      if (!next_game_state)
+      {
+        continue;
+      }
+
+      next_game_state->set_id(this->m_arena.add(next_game_state->parent_id(), move));
+
+      // Candidates are found out of order, so record_best() decides between them just like it does for parallel workers
+      if (next_game_state->goal_combo() != game_state.goal_combo())
+      {
+        this->record_best(worker.m_best, next_game_state.value(), this->m_arena.route(next_game_state->id()));
+      }
+
+      if (!next_game_state->is_terminal() && this->can_improve(next_game_state.value()))
+      {
+        auto const estimate = static_cast<std::uint8_t>(this->optimistic_goals(next_game_state.value()));
+        auto const moves_taken = static_cast<std::uint8_t>(next_game_state->moves_taken());
+
+        frontier.push_back(frontier_entry_t{next_game_state->pack(), estimate, moves_taken});
+        std::push_heap(std::begin(frontier), std::end(frontier), less_promising);
+      }
+    }
+  }
+}
+
+
+auto puzzler::best_first_search() -> std::map<std::size_t, game_state_t>
+{
+  auto &worker = *this->m_workers.front();
+
+  // Routes aren't found in order, so ones that tie with the bound have to be kept in case they come first
+  this->m_keep_ties = true;
+
+  dispatch_board(this->m_game_states.front().puzzle().board(), [this](auto const &board) { this->search_best_first(board); });
+
+  spdlog::info("Expanded {} states ({} pruned, {}) to find {} optimal solution(s)", worker.m_states_explored, worker.m_states_pruned, this->pruning_summary(), worker.m_best.size());
+
+  return worker.m_best;
+}
+
+
+template<typename Board>
+auto puzzler::search_beam(Board const &board) -> void
+{
+  auto &worker = *this->m_workers.front();
+
+  // The most promising first - the most goals completed, then the most still in reach, then the most codes matched towards
+  // those, then whichever route comes first
+  auto const more_promising = [this](beam_entry_t const &lhs, beam_entry_t const &rhs) {
+    if (lhs.m_completed != rhs.m_completed)
+    {
+      return lhs.m_completed > rhs.m_completed;
+    }
+
+    if (lhs.m_reachable != rhs.m_reachable)
+    {
+      return lhs.m_reachable > rhs.m_reachable;
+    }
+
+    if (lhs.m_progress != rhs.m_progress)
+    {
+      return lhs.m_progress > rhs.m_progress;
+    }
+
+    return this->m_arena.route_before(lhs.m_state.m_id, rhs.m_state.m_id);
+  };
+
+  auto const &root = this->m_game_states.front();
+  auto beam = std::vector<beam_entry_t>{};
+  beam.push_back(this->beam_entry(root));
+
+  while (!beam.empty())
+  {
+    auto candidates = std::vector<beam_entry_t>{};
+
+    for (auto const &entry : beam)
+    {
+      auto const game_state = root.unpack(entry.m_state);
+      ++worker.m_states_explored;
+
+      // Everything left on this level is just as far along as this one
+      if (this->stopping(worker.m_states_explored))
+      {
+        this->stop_unexplored(game_state.moves_taken());
+        return;
+      }
+
+      for (cell_mask_t moves = game_state.valid_moves(board); moves != 0; moves &= moves - 1)
+      {
+        std::size_t const move = count_trailing_zeros(moves);
+        auto next_game_state = game_state.make_move(move);
+
+        if (!next_game_state)
+        {
+          continue;
+        }
+
+        next_game_state->set_id(this->m_arena.add(next_game_state->parent_id(), move));
+
+        // Candidates on the same level aren't found in route order, so record_best() decides between them
+        if (next_game_state->goal_combo() != game_state.goal_combo())
+        {
+          this->record_best(worker.m_best, next_game_state.value(), this->m_arena.route(next_game_state->id()));
+        }
+
+        if (!next_game_state->is_terminal() && this->can_improve(next_game_state.value()))
+        {
+          candidates.push_back(this->beam_entry(next_game_state.value()));
+        }
+      }
+    }
+
+    // Every state on the next level has made the same number of moves, so they can be compared on goal progress alone
+    std::sort(std::begin(candidates), std::end(candidates), more_promising);
+
+    for (auto &stage : worker.m_pruning_stages)
+    {
+      stage->next_level();
+    }
+
+    // Keep the most promising states we haven't already seen another route to. Anything past those might have led to a
+    // better route, so routes that need more moves than this level can't be proven optimal
+    beam.clear();
+
+    for (auto const &entry : candidates)
+    {
+      auto const game_state = root.unpack(entry.m_state);
+
+      if (beam.size() == this->m_beam_width)
+      {
+        this->stop_unexplored(game_state.moves_taken());
+        break;
+      }
+
+      if (this->admit(worker, game_state))
+      {
+        beam.push_back(entry);
+      }
+    }
+
+    worker.m_states_pruned += candidates.size() - beam.size();
+  }
+}
+
+
+auto puzzler::beam_search() -> std::map<std::size_t, game_state_t>
+{
+  auto &worker = *this->m_workers.front();
+
+  // Routes on the same level aren't found in order, so ones that tie with the bound have to be kept in case they come first
+  this->m_keep_ties = true;
+
+  dispatch_board(this->m_game_states.front().puzzle().board(), [this](auto const &board) { this->search_beam(board); });
+
+  spdlog::info("Expanded {} states ({} left behind or pruned, {}) with a beam {} wide to find {} solution(s)", worker.m_states_explored, worker.m_states_pruned, this->pruning_summary(), this->m_beam_width, worker.m_best.size());
+
+  return worker.m_best;
+}
+
+
+auto puzzler::parallel_branch_and_bound() -> std::map<std::size_t, game_state_t>
+{
+  this->m_keep_ties = true;
+
+  // Every other worker gets its own copy of the first worker's pruning stages
+  while (this->m_workers.size() < this->m_threads)
+  {
+    auto worker = std::make_unique<search_worker_t>();
+
+    for (auto const &stage : this->m_workers.front()->m_pruning_stages)
+    {
+      worker->m_pruning_stages.push_back(stage->fresh());
+    }
+
+    this->m_workers.push_back(std::move(worker));
+  }
+
+  // The first task is the whole tree, which gets split up by its first move
+  this->m_workers.front()->m_tasks.push_back(search_task_t{this->m_game_states.front(), route_t{}});
+  this->m_tasks_pending = 1;
+
+  auto threads = std::vector<std::thread>{};
+
+  for (std::size_t i = 1; i < this->m_threads; ++i)
+  {
+    threads.emplace_back(&puzzler::run_worker, this, i);
+  }
+
+  this->run_worker(0);
+
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+
+  // Merge what each worker found, using the same rules they did
+  auto best = std::map<std::size_t, game_state_t>{};
+  std::size_t states_explored = 0;
+  std::size_t states_pruned = 0;
+
+  for (auto const &worker : this->m_workers)
+  {
+    for (auto const &[combo, solution] : worker->m_best)
+    {
+      this->record_best(best, solution, solution.route());
+    }
+
+    states_explored += worker->m_states_explored;
+    states_pruned += worker->m_states_pruned;
+  }
+
+  spdlog::info("Explored {} states ({} pruned, {}) on {} threads to find {} optimal solution(s)", states_explored, states_pruned, this->pruning_summary(), this->m_threads, best.size());
+
+  return best;
+}
+
+
+auto puzzler::solve(std::optional<std::chrono::steady_clock::time_point> const deadline, cancellation_token_t const &cancel) -> std::map<std::size_t, game_state_t>
+{
+  this->m_deadline = deadline;
+  this->m_cancel = cancel;
+
+  auto const root = this->m_game_states.front();
+  auto solutions = std::map<std::size_t, game_state_t>{};
+
+  if (this->m_strategy == search_strategy_t::sequence_first)
+  {
+    // The sequencer doesn't search the grid the same way at all, and it's quick enough to always run to the end. If it's
+    // cancelled part way through, there's no telling what it missed
+    solutions = sequencer{this->m_game_states.front(), cancel}.solve();
+
+    if (cancel.cancelled())
+    {
+      this->m_stopping.store(true, std::memory_order_relaxed);
+      this->stop_unexplored(0);
+    }
+  } else if (this->m_threads > 1)
+  {
+    // Only the depth-first search can be split up between threads
+    solutions = this->parallel_branch_and_bound();
+  } else
+  {
+    switch (this->m_strategy)
+    {
+      case search_strategy_t::depth_first:
+        solutions = this->branch_and_bound();
+        break;
+
+      case search_strategy_t::best_first:
+        solutions = this->best_first_search();
+        break;
+
+      case search_strategy_t::beam:
+        solutions = this->beam_search();
+        break;
+
+      case search_strategy_t::breadth_first:
+      default:
+        this->calculate_all_routes();
+        solutions = this->pick_best_routes();
+        break;
+    }
+  }
+
+  // The searches only know the moves they made themselves
+  for (auto &[combo, solution] : solutions)
+  {
+    solution.set_route(this->full_route(solution.route()));
+  }
+
+  // Whatever the moves made before we started have already completed can't be done any quicker, and anything else has to
+  // complete more on top of it
+  if (root.goal_combo() != 0)
+  {
+    solutions.emplace(root.goal_combo(), root);
+  }
+
+  this->mark_proven(solutions);
+
+  return solutions;
+}
+
+
+auto puzzler::solve_async(std::optional<std::chrono::steady_clock::time_point> const deadline, cancellation_token_t const &cancel) -> std::future<std::map<std::size_t, game_state_t>>
+{
+  return std::async(std::launch::async, [this, deadline, cancel]() { return this->solve(deadline, cancel); });
+}
+
+
+auto puzzler::solve_weighted(std::vector<std::size_t> const &weights, std::optional<std::chrono::steady_clock::time_point> const deadline, cancellation_token_t const &cancel) -> std::optional<game_state_t>
+{
+  if (weights.size() != this->m_total_goals || std::find(std::begin(weights), std::end(weights), std::size_t{0}) != std::end(weights))
+  {
+    spdlog::error("Need a weight of at least 1 for each of the {} target sequences", this->m_total_goals);
+    return std::nullopt;
+  }
+
+  if (this->m_strategy != search_strategy_t::depth_first)
+  {
+    spdlog::info("Searching depth-first, since that's the only search that can prune by weight");
+    this->m_strategy = search_strategy_t::depth_first;
+  }
+
+  // Each combination is worth the weights of its goals added up - the same as it is without its lowest goal, plus that
+  this->m_combo_weights.assign(std::size_t{1} << this->m_total_goals, 0);
+
+  for (std::size_t combo = 1; combo < this->m_combo_weights.size(); ++combo)
+  {
+    this->m_combo_weights[combo] = this->m_combo_weights[combo & (combo - 1)] + weights[count_trailing_zeros(combo)];
+  }
+
+  // What the moves made before we started have already completed is as good as it gets so far
+  auto const &root = this->m_game_states.front();
+  this->m_incumbent.store(root.goal_combo() == 0 ? 0 : weighted_score(this->m_combo_weights[root.goal_combo()], root.scoring_moves()), std::memory_order_relaxed);
+
+  auto const solutions = this->solve(deadline, cancel);
+
+  // Anything pruned along the way was worth less than one of these
+  auto best = std::optional<game_state_t>{};
+  auto const score = [this](game_state_t const &solution) { return weighted_score(this->m_combo_weights[solution.goal_combo()], solution.scoring_moves()); };
+
+  for (auto const &[combo, solution] : solutions)
+  {
+    if (!best || score(solution) > score(*best) || (score(solution) == score(*best) && solution.route() < best->route()))
+    {
+      best = solution;
+    }
+  }
+
+  return best;
+}
+
+
+auto puzzler::solve_alternatives(std::size_t const count, std::optional<std::chrono::steady_clock::time_point> const deadline, cancellation_token_t const &cancel) -> std::map<std::size_t, std::vector<game_state_t>>
+{
+  if (this->m_strategy != search_strategy_t::depth_first)
+  {
+    spdlog::info("Searching depth-first, since that's the only search that can keep alternative routes");
+    this->m_strategy = search_strategy_t::depth_first;
+  }
+
+  // A repeat of a state we've seen before is another route to it, so the transposition table and dominance checks have
+  // to go. The other workers copy the first one's stages
+  this->m_alternatives = std::max(count, std::size_t{1});
+  this->m_workers.front()->m_pruning_stages.clear();
+
+  auto const best = this->solve(deadline, cancel);
+
+  // Merge what each worker kept, using the same rules they did
+  auto merged = std::map<std::size_t, std::vector<game_state_t>>{};
+
+  for (auto const &worker : this->m_workers)
+  {
+    for (auto const &[combo, alternatives] : worker->m_alternatives)
+    {
+      for (auto const &alternative : alternatives)
+      {
+        this->record_alternative(merged[combo], alternative, alternative.route());
+      }
+    }
+  }
+
+  // Only for the combinations worth reporting at all, best first
+  auto result = std::map<std::size_t, std::vector<game_state_t>>{};
+
+  for (auto const &[combo, solution] : best)
+  {
+    auto &alternatives = result[combo];
+    auto const it = merged.find(combo);
+
+    // The only way the search won't have kept anything is if the moves made before it started had already done it
+    if (it == std::end(merged) || this->m_alternatives == 1)
+    {
+      alternatives.push_back(solution);
+      continue;
+    }
+
+    alternatives = it->second;
+    std::sort_heap(std::begin(alternatives), std::end(alternatives), [](game_state_t const &lhs, game_state_t const &rhs) { return beats(lhs, lhs.route(), rhs); });
+
+    for (auto &alternative : alternatives)
+    {
+      alternative.set_route(this->full_route(alternative.route()));
+      alternative.set_proven(this->is_proven(alternative));
+    }
+  }
+
+  return result;
+}
+
+
+auto puzzler::solve_every_buffer(std::optional<std::chrono::steady_clock::time_point> const deadline, cancellation_token_t const &cancel) -> std::map<std::size_t, std::map<std::size_t, game_state_t>>
+{
+  std::size_t const max_buffer_size = this->m_game_states.front().buffer_size();
+  auto const solutions = this->solve(deadline, cancel);
+
+  // A route that fits in a smaller buffer is the best it can have for its goals, since nothing shorter was found with more
+  // room
+  auto table = std::map<std::size_t, std::map<std::size_t, game_state_t>>{};
+
+  for (std::size_t buffer_size = 1; buffer_size <= max_buffer_size; ++buffer_size)
+  {
+    auto &fits = table[buffer_size];
+
+    for (auto const &[combo, solution] : solutions)
+    {
+      if (solution.scoring_moves() <= buffer_size)
+      {
+        fits.emplace(combo, solution);
+      }
+    }
+  }
 
-  return this->pick_best_routes();
+  return table;
 }
 
 } // namespace pnkd
@@ -0,0 +1,282 @@
+#include "core/sequencer.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include <spdlog/spdlog.h>
+
+#include "utils/bit_utils.hpp"
+
+namespace pnkd
+{
+
+auto overlaps(symbol_seq_t const &pattern, symbol_seq_t const &goal) -> std::vector<std::size_t>
+{
+  auto result = std::vector<std::size_t>{};
+
+  if (goal.empty())
+  {
+    return result;
+  }
+
+  // KMP prefix function - for each prefix of the goal, the length of the longest proper prefix that's also a suffix of it
+  auto prefix = std::vector<std::size_t>(goal.size(), 0);
+
+  for (std::size_t i = 1, k = 0; i < goal.size(); ++i)
+  {
+    while (k > 0 && goal[i] != goal[k])
+    {
+      k = prefix[k - 1];
+    }
+
+    if (goal[i] == goal[k])
+    {
+      ++k;
+    }
+
+    prefix[i] = k;
+  }
+
+  // Run the pattern through it, to find the longest end of the pattern that the goal could start with
+  std::size_t matched = 0;
+
+  for (symbol_t const symbol : pattern)
+  {
+    if (matched == goal.size())
+    {
+      matched = prefix[matched - 1];
+    }
+
+    while (matched > 0 && goal[matched] != symbol)
+    {
+      matched = prefix[matched - 1];
+    }
+
+    if (goal[matched] == symbol)
+    {
+      ++matched;
+    }
+  }
+
+  // Every shorter overlap is a border of the longest one
+  if (matched == goal.size())
+  {
+    matched = prefix[matched - 1];
+  }
+
+  for (; matched > 0; matched = prefix[matched - 1])
+  {
+    result.push_back(matched);
+  }
+
+  return result;
+}
+
+
+sequencer::sequencer(game_state_t const &game_state, cancellation_token_t cancel) : m_root(game_state), m_oracle(game_state.puzzle()), m_cancel(std::move(cancel))
+{
+  for (auto const &goal : game_state.puzzle().goals())
+  {
+    this->m_goal_symbols.push_back(goal.m_symbols);
+  }
+}
+
+
+auto sequencer::add_targets(symbol_seq_t const &pattern, std::size_t const placed, std::size_t const goal_combo) -> void
+{
+  std::size_t const buffer_size = this->m_root.buffer_size();
+
+  // With a lot of goals there are a lot of ways to fit them together, so this can take a while
+  if (this->m_cancel.cancelled())
+  {
+    return;
+  }
+
+  if (placed == goal_combo)
+  {
+    this->m_targets.push_back(target_t{pattern, goal_combo});
+    return;
+  }
+
+  // Try each goal we haven't placed yet as the next one along
+  for (std::size_t i = 0; i < this->m_goal_symbols.size(); ++i)
+  {
+    std::size_t const goal_bit = std::size_t{1} << i;
+
+    if ((goal_combo & goal_bit) == 0 || (placed & goal_bit) != 0)
+    {
+      continue;
+    }
+
+    auto const &goal = this->m_goal_symbols[i];
+
+    // It might already be spelled out by the goals before it
+    if (std::search(std::begin(pattern), std::end(pattern), std::begin(goal), std::end(goal)) != std::end(pattern))
+    {
+      this->add_targets(pattern, placed | goal_bit, goal_combo);
+    }
+
+    // Or it could start on the last few codes of the pattern, or straight after it
+    auto joins = overlaps(pattern, goal);
+    joins.push_back(0);
+
+    for (std::size_t const overlap : joins)
+    {
+      if (pattern.size() + goal.size() - overlap <= buffer_size)
+      {
+        auto next = pattern;
+        next.insert(std::end(next), std::next(std::begin(goal), static_cast<std::ptrdiff_t>(overlap)), std::end(goal));
+        this->add_targets(next, placed | goal_bit, goal_combo);
+      }
+    }
+
+    // Or there might have to be a few other moves in between, to get from the end of one goal to the start of the next
+    // (before the first goal, that's already taken care of by the padding the pattern starts with)
+    for (std::size_t gap = 1; placed != 0 && pattern.size() + gap + goal.size() <= buffer_size; ++gap)
+    {
+      auto next = pattern;
+      next.insert(std::end(next), gap, any_symbol);
+      next.insert(std::end(next), std::begin(goal), std::end(goal));
+      this->add_targets(next, placed | goal_bit, goal_combo);
+    }
+  }
+}
+
+
+auto sequencer::build_targets() -> void
+{
+  this->m_targets.clear();
+
+  // Every combination of goals, with however many moves it takes to get to the first one
+  for (std::size_t goal_combo = 1; goal_combo < (std::size_t{1} << this->m_goal_symbols.size()); ++goal_combo)
+  {
+    for (std::size_t padding = 0; padding < this->m_root.buffer_size(); ++padding)
+    {
+      this->add_targets(symbol_seq_t(padding, any_symbol), 0, goal_combo);
+    }
+  }
+
+  // Shortest first, and only once each
+  std::sort(std::begin(this->m_targets), std::end(this->m_targets));
+  this->m_targets.erase(std::unique(std::begin(this->m_targets), std::end(this->m_targets), [](target_t const &lhs, target_t const &rhs) { return lhs.m_pattern == rhs.m_pattern && lhs.m_goal_combo == rhs.m_goal_combo; }), std::end(this->m_targets));
+}
+
+
+// Walks the cells the oracle says each step could be on, checking along the way what it can't - that no cell is used
+// twice, and that the goals we're after don't get failed along the way
+auto sequencer::spell(game_state_t const &game_state, target_t const &target, std::vector<cell_mask_t> const &alive, route_t &route) const -> std::optional<game_state_t>
+{
+  auto const &puzzle = game_state.puzzle();
+  std::size_t const step = route.size();
+
+  // Did we spell out the whole pattern, and did it complete exactly what it was meant to (on its last move)? A route that
+  // happens to complete other goals too belongs to a different combination, which has targets of its own
+  if (step == target.m_pattern.size())
+  {
+    if (game_state.goal_combo() == target.m_goal_combo && game_state.scoring_moves() == step)
+    {
+      return game_state;
+    }
+
+    return std::nullopt;
+  }
+
+  for (cell_mask_t moves = game_state.valid_moves() & alive[step]; moves != 0; moves &= moves - 1)
+  {
+    std::size_t const move = count_trailing_zeros(moves);
+    auto next_game_state = game_state.make_move(move);
+
+    if (!next_game_state)
+    {
+      continue;
+    }
+
+    // Give up on this move if it has already failed one of the goals we're trying to complete
+    bool failed = false;
+
+    for (std::size_t i = 0; i < puzzle.num_goals(); ++i)
+    {
+      failed |= ((target.m_goal_combo >> i) & 1U) != 0 && progress_code(next_game_state->progress(), i) > puzzle.goal_length(i);
+    }
+
+    if (failed)
+    {
+      continue;
+    }
+
+    route.push_back(move);
+
+    if (auto found = this->spell(next_game_state.value(), target, alive, route))
+    {
+      return found;
+    }
+
+    route.pop_back();
+  }
+
+  return std::nullopt;
+}
+
+
+auto sequencer::record_best(game_state_t const &candidate, route_t const &route) -> void
+{
+  auto const goal_combo = candidate.goal_combo();
+  auto const it = this->m_best.find(goal_combo);
+
+  // Same rules as the puzzler - fewest moves wins, then whichever route comes first
+  if (it == std::end(this->m_best) || candidate.scoring_moves() < it->second.scoring_moves() || (candidate.scoring_moves() == it->second.scoring_moves() && route < it->second.route()))
+  {
+    auto best = candidate;
+    best.set_route(route);
+    this->m_best[goal_combo] = best;
+  }
+}
+
+
+auto sequencer::solve() -> std::map<std::size_t, game_state_t>
+{
+  this->build_targets();
+
+  std::size_t spelled = 0;
+
+  for (auto const &target : this->m_targets)
+  {
+    if (this->m_cancel.cancelled())
+    {
+      spdlog::debug("Cancelled after spelling {} target sequences", spelled);
+      break;
+    }
+
+    // Nothing this long can beat a route we already have for these goals (although it could tie with it)
+    auto const it = this->m_best.find(target.m_goal_combo);
+
+    if (it != std::end(this->m_best) && it->second.scoring_moves() < target.m_pattern.size())
+    {
+      continue;
+    }
+
+    // Most targets can't be spelled at all, and the oracle can tell us that without a search. For the rest, it narrows
+    // each step down to the cells that can still finish the pattern
+    auto const alive = this->m_oracle.reachable(target.m_pattern);
+
+    if (alive.empty())
+    {
+      continue;
+    }
+
+    auto route = route_t{};
+    route.reserve(target.m_pattern.size());
+
+    if (auto const found = this->spell(this->m_root, target, alive, route))
+    {
+      ++spelled;
+      this->record_best(found.value(), route);
+    }
+  }
+
+  spdlog::info("Spelled {} of {} target sequences to find {} optimal solution(s)", spelled, this->m_targets.size(), this->m_best.size());
+
+  return this->m_best;
+}
+
+} // namespace pnkd
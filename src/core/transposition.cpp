@@ -0,0 +1,102 @@
+#include "core/transposition.hpp"
+
+#include <algorithm>
+
+namespace pnkd
+{
+
+transposition_table_t::transposition_table_t(std::size_t const max_slots) : m_max_slots(max_slots)
+{
+  std::size_t slots = initial_slots;
+
+  // Keep the number of slots a power of two, so a hash can be turned into an index with a mask
+  if (max_slots != 0)
+  {
+    while (slots > max_slots && slots > 1)
+    {
+      slots /= 2;
+    }
+  }
+
+  this->m_slots.resize(slots);
+}
+
+
+auto transposition_table_t::insert(state_key_t const &key) -> bool
+{
+  // Keep the table at most half full when it's allowed to grow, so probe sequences stay short
+  if ((this->m_max_slots == 0 || this->m_slots.size() * 2 <= this->m_max_slots) && (this->m_size + 1) * 2 > this->m_slots.size())
+  {
+    this->grow();
+  }
+
+  std::size_t const mask = this->m_slots.size() - 1;
+  std::size_t const home = static_cast<std::size_t>(key.m_hash) & mask;
+
+  for (std::size_t probe = 0; probe < max_probes; ++probe)
+  {
+    auto &slot = this->m_slots[(home + probe) & mask];
+
+    if (slot.m_generation != this->m_generation)
+    {
+      slot = slot_t{key, this->m_generation};
+      ++this->m_size;
+      return true;
+    }
+
+    if (slot.m_key == key)
+    {
+      ++this->m_hits;
+      return false;
+    }
+  }
+
+  // Nowhere left to put it nearby, so it replaces whatever was in its home slot
+  this->m_slots[home] = slot_t{key, this->m_generation};
+  return true;
+}
+
+
+auto transposition_table_t::grow() -> void
+{
+  auto old_slots = std::vector<slot_t>(this->m_slots.size() * 2);
+  std::swap(old_slots, this->m_slots);
+
+  this->m_size = 0;
+
+  for (auto const &slot : old_slots)
+  {
+    if (slot.m_generation == this->m_generation)
+    {
+      // Re-inserting can't recurse back into grow(), as the new table is at most a quarter full
+      this->insert(slot.m_key);
+    }
+  }
+}
+
+
+auto transposition_table_t::clear() -> void
+{
+  // Only wipe the slots for real on the rare occasion that the generation wraps around
+  if (++this->m_generation == 0)
+  {
+    std::fill(std::begin(this->m_slots), std::end(this->m_slots), slot_t{});
+    this->m_generation = 1;
+  }
+
+  this->m_size = 0;
+}
+
+
+auto transposition_table_t::size() const -> std::size_t
+{
+  return this->m_size;
+}
+
+
+auto transposition_table_t::hits() const -> std::size_t
+{
+  return this->m_hits;
+}
+
+} // namespace pnkd
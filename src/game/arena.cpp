@@ -0,0 +1,73 @@
+#include "game/arena.hpp"
+
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+
+namespace pnkd
+{
+
+auto state_arena_t::add(state_id_t const parent, std::size_t const move) -> state_id_t
+{
+  // The last id is reserved to mean "no state", so once we reach it the arena is full
+  if (this->m_entries.size() >= no_state)
+  {
+    spdlog::error("State arena is full!");
+    return no_state;
+  }
+
+  this->m_entries.push_back(entry_t{parent, static_cast<std::uint8_t>(move)});
+
+  return static_cast<state_id_t>(this->m_entries.size() - 1);
+}
+
+auto state_arena_t::clear() -> void
+{
+  this->m_entries.clear();
+}
+
+auto state_arena_t::parent(state_id_t const id) const -> state_id_t
+{
+  return (id < this->m_entries.size()) ? this->m_entries[id].m_parent : no_state;
+}
+
+auto state_arena_t::move(state_id_t const id) const -> std::size_t
+{
+  return (id < this->m_entries.size()) ? this->m_entries[id].m_move : 0;
+}
+
+auto state_arena_t::route(state_id_t const id) const -> route_t
+{
+  auto route = route_t{};
+
+  // Walk back up to the root (which has no parent, and didn't make a move to get where it is)
+  for (state_id_t current = id; current < this->m_entries.size() && this->m_entries[current].m_parent != no_state; current = this->m_entries[current].m_parent)
+  {
+    route.push_back(this->m_entries[current].m_move);
+  }
+
+  std::reverse(std::begin(route), std::end(route));
+
+  return route;
+}
+
+auto state_arena_t::route_before(state_id_t const lhs, state_id_t const rhs) const -> bool
+{
+  // Both routes are the same length, so they split wherever their parents first match
+  for (state_id_t left = lhs, right = rhs; left != right && left < this->m_entries.size() && right < this->m_entries.size(); left = this->m_entries[left].m_parent, right = this->m_entries[right].m_parent)
+  {
+    if (this->m_entries[left].m_parent == this->m_entries[right].m_parent)
+    {
+      return this->m_entries[left].m_move < this->m_entries[right].m_move;
+    }
+  }
+
+  return false;
+}
+
+auto state_arena_t::size() const -> std::size_t
+{
+  return this->m_entries.size();
+}
+
+} // namespace pnkd
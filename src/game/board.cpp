@@ -0,0 +1,48 @@
+#include "game/board.hpp"
+
+#include "game/point.hpp"
+
+namespace pnkd
+{
+
+dynamic_board_t::dynamic_board_t(std::size_t const grid_width) : m_grid_width(grid_width), m_rows(grid_width, 0), m_cols(grid_width, 0)
+{
+  std::size_t const grid_size = grid_width * grid_width;
+
+  for (std::size_t pos = 0; pos < grid_size; ++pos)
+  {
+    auto const [col, row] = point_t::pos_to_xy(pos, grid_width);
+    cell_mask_t const cell = cell_mask_t{1} << pos;
+
+    this->m_rows[row] |= cell;
+    this->m_cols[col] |= cell;
+    this->m_all_cells |= cell;
+  }
+
+  for (std::size_t pos = 0; pos < grid_size; ++pos)
+  {
+    auto const [col, row] = point_t::pos_to_xy(pos, grid_width);
+
+    this->m_row_masks.push_back(this->m_rows[row]);
+    this->m_col_masks.push_back(this->m_cols[col]);
+  }
+}
+
+
+auto dynamic_board_t::spread(cell_mask_t const cells, bool const vertical) const -> cell_mask_t
+{
+  auto const &lines = vertical ? this->m_cols : this->m_rows;
+  cell_mask_t result = 0;
+
+  for (cell_mask_t const line : lines)
+  {
+    if ((cells & line) != 0)
+    {
+      result |= line;
+    }
+  }
+
+  return result;
+}
+
+} // namespace pnkd
@@ -24,20 +24,17 @@ goal_list_t::goal_list_t(std::vector<std::vector<std::string>> const &vec_of_goa
       continue;
     }
 
-    auto this_goal = std::queue<std::string>{};
-
     auto goal_str = std::string{};
     goal_str.reserve((goal.size() * 3) - 1);
 
     for (auto const &segment : goal)
     {
-      this_goal.push(segment);
       goal_str += " " + segment;
     }
 
     goal_str = pnkd::strip(goal_str);
 
-    this->emplace_back(pnkd::goal_t{this_goal, goal_str, goal_num++});
+    this->emplace_back(pnkd::goal_t{goal, goal_str, goal_num++});
   }
 
   this->init();
@@ -82,27 +79,27 @@ auto goal_list_t::init() -> void
 
 auto goal_t::empty() const -> bool
 {
-  return this->m_goal.empty();
+  return this->m_failed || this->m_matched >= this->m_symbols.size();
 }
 
-auto goal_t::front() const -> std::string const &
+auto goal_t::front() const -> symbol_t
 {
-  return this->m_goal.front();
+  return this->m_symbols[this->m_matched];
 }
 
-auto goal_t::front() -> std::string &
+auto goal_t::pop() -> void
 {
-  return this->m_goal.front();
+  ++this->m_matched;
 }
 
-auto goal_t::pop() -> void
+auto goal_t::fail() -> void
 {
-  this->m_goal.pop();
+  this->m_failed = true;
 }
 
 auto goal_t::size() const -> std::size_t
 {
-  return this->m_goal.size();
+  return this->empty() ? 0 : this->m_symbols.size() - this->m_matched;
 }
 
 auto goal_t::seq_len() const -> std::size_t
@@ -126,6 +123,12 @@ auto goal_t::completed_in(std::size_t const moves_taken) -> void
   this->m_moves_taken = moves_taken;
 }
 
+auto goal_t::progress_code() const -> std::uint8_t
+{
+  // 0 to seq_len() is how much of the sequence has been matched so far, and anything past that means the goal was failed
+  return static_cast<std::uint8_t>(this->m_failed ? this->m_length + 1 : this->m_matched);
+}
+
 auto goal_t::num() const -> std::size_t
 {
   return this->m_num;
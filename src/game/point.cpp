@@ -1,6 +1,5 @@
 #include "game/point.hpp"
 
-#include <cmath>
 #include <sstream>
 
 #include <spdlog/spdlog.h>
@@ -12,7 +11,7 @@ static constexpr std::size_t default_grid_size = 25;
 
 point_t::point_t() : m_pos(0), m_grid_size(default_grid_size)
 {
-  auto const grid_width = static_cast<std::size_t>(std::sqrt(default_grid_size));
+  auto const grid_width = width_of(default_grid_size);
 
   this->m_grid_width = grid_width;
   this->m_valid = true;
@@ -20,7 +19,7 @@ point_t::point_t() : m_pos(0), m_grid_size(default_grid_size)
 
 point_t::point_t(std::size_t const grid_size) : m_pos(0), m_grid_size(grid_size)
 {
-  auto const grid_width = static_cast<std::size_t>(std::sqrt(grid_size));
+  auto const grid_width = width_of(grid_size);
 
   // We expect grids that are perfect squares
   if (grid_width * grid_width != grid_size)
@@ -37,7 +36,7 @@ point_t::point_t(std::size_t const grid_size) : m_pos(0), m_grid_size(grid_size)
 
 point_t::point_t(std::size_t const pos, std::size_t const grid_size) : m_pos(pos), m_grid_size(grid_size)
 {
-  auto const grid_width = static_cast<std::size_t>(std::sqrt(grid_size));
+  auto const grid_width = width_of(grid_size);
 
   // We expect grids that are perfect squares
   if (grid_width * grid_width != grid_size)
@@ -0,0 +1,163 @@
+#include "game/puzzle.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <stdexcept>
+
+#include <spdlog/spdlog.h>
+
+#include "game/point.hpp"
+
+namespace pnkd
+{
+
+auto const is_perfect_square = [](std::size_t const n) {
+  // Ignore empty grids
+  if (n == 0)
+  {
+    return false;
+  }
+
+  std::size_t const width = point_t::width_of(n);
+
+  return (width * width == n);
+};
+
+
+puzzle_t::puzzle_t(grid_t const &grid, goal_list_t const &goals, std::size_t const buffer_size) : m_grid(grid), m_grid_size(grid.size()), m_goal_list(goals), m_buffer_size(buffer_size)
+{
+  std::size_t const grid_size = grid.size();
+
+  // We expect grids that are perfect squares
+  if (!is_perfect_square(grid_size))
+  {
+    throw std::invalid_argument{fmt::format("Invalid grid size: {}", grid_size)};
+  }
+
+  // Solving only part of a bigger grid would give routes for a different puzzle, so don't try
+  if (grid_size > max_grid_size)
+  {
+    throw std::invalid_argument{fmt::format("Grid has {} cells, but at most {} are supported", grid_size, max_grid_size)};
+  }
+
+  // Likewise for the goals
+  if (this->m_goal_list.size() > max_goals)
+  {
+    throw std::invalid_argument{fmt::format("Found {} goals, but at most {} are supported", this->m_goal_list.size(), max_goals)};
+  }
+
+  this->m_grid_width = point_t::width_of(grid_size);
+  this->m_board = dynamic_board_t{this->m_grid_width};
+
+  // Intern every code in the grid and the goals, so that from here on the solver only has to compare bytes
+  this->m_cells = this->m_alphabet.intern(grid);
+
+  for (auto &goal : this->m_goal_list)
+  {
+    goal.m_symbols = this->m_alphabet.intern(goal.m_codes);
+    goal.m_matched = 0;
+  }
+
+  // Zobrist keys, so a state's hash can be updated with a few XORs as each move is made.
+  // The seed is fixed so that solves are repeatable
+  auto random_engine = std::mt19937_64{grid_size};
+
+  auto const random_keys = [&random_engine](std::size_t const quantity) {
+    auto keys = std::vector<std::uint64_t>(quantity);
+    std::generate(std::begin(keys), std::end(keys), std::ref(random_engine));
+    return keys;
+  };
+
+  this->m_history_keys = random_keys(grid_size);
+  this->m_position_keys = random_keys(grid_size);
+  this->m_direction_key = random_engine();
+
+  for (auto const &goal : this->m_goal_list)
+  {
+    this->m_goal_keys.push_back(random_keys(goal.seq_len() + 2)); // One for each amount matched, plus one for failing it
+  }
+
+  // Build the transition table for every goal. Matching the next code in the sequence moves a goal on, but once it has
+  // been started anything else fails it. Completed and failed goals stay that way
+  for (auto const &goal : this->m_goal_list)
+  {
+    this->m_goal_lengths.push_back(static_cast<std::uint8_t>(goal.seq_len()));
+    this->m_progress_codes = std::max(this->m_progress_codes, goal.seq_len() + 2);
+  }
+
+  std::size_t const num_goals = this->m_goal_lengths.size();
+  this->m_transitions.resize(this->m_alphabet.size() * num_goals * this->m_progress_codes);
+
+  for (std::size_t symbol = 0; symbol < this->m_alphabet.size(); ++symbol)
+  {
+    for (std::size_t goal = 0; goal < num_goals; ++goal)
+    {
+      auto const &symbols = this->m_goal_list[goal].m_symbols;
+      std::size_t const length = this->m_goal_lengths[goal];
+
+      for (std::size_t code = 0; code < this->m_progress_codes; ++code)
+      {
+        std::size_t next = code;
+
+        if (code < length)
+        {
+          if (symbols[code] == symbol)
+          {
+            next = code + 1;
+          } else if (code != 0)
+          {
+            next = length + 1;
+          }
+        }
+
+        this->m_transitions[(((symbol * num_goals) + goal) * this->m_progress_codes) + code] = static_cast<std::uint8_t>(next);
+      }
+    }
+  }
+
+  for (std::size_t goal = 0; goal < num_goals; ++goal)
+  {
+    this->m_all_failed = set_progress_code(this->m_all_failed, goal, static_cast<std::uint8_t>(this->m_goal_lengths[goal] + 1));
+  }
+
+  spdlog::debug("Created puzzle_t for a {}x{} ({}) grid with {} goals and a buffer size of {}", this->m_grid_width, this->m_grid_width, grid_size, goals.size(), buffer_size);
+}
+
+
+auto puzzle_t::grid() const -> grid_t const &
+{
+  return this->m_grid;
+}
+
+auto puzzle_t::alphabet() const -> alphabet_t const &
+{
+  return this->m_alphabet;
+}
+
+auto puzzle_t::cells() const -> symbol_seq_t const &
+{
+  return this->m_cells;
+}
+
+auto puzzle_t::grid_size() const -> std::size_t
+{
+  return this->m_grid_size;
+}
+
+auto puzzle_t::grid_width() const -> std::size_t
+{
+  return this->m_grid_width;
+}
+
+auto puzzle_t::goals() const -> goal_list_t const &
+{
+  return this->m_goal_list;
+}
+
+auto puzzle_t::buffer_size() const -> std::size_t
+{
+  return this->m_buffer_size;
+}
+
+} // namespace pnkd
@@ -2,6 +2,8 @@
 
 #include <sstream>
 
+#include "utils/string_utils.hpp"
+
 namespace pnkd
 {
 
@@ -37,4 +39,27 @@ auto route_t::first_n(std::size_t const n) const -> route_t
   }
 }
 
+auto parse_route(std::string const &text) -> std::optional<route_t>
+{
+  // An arrow is just another way of writing a comma. Only whole arrows count, so a stray '-' is left in the way
+  auto commas = text;
+
+  for (auto pos = commas.find("->"); pos != std::string::npos; pos = commas.find("->", pos))
+  {
+    commas.replace(pos, 2, ",");
+  }
+
+  auto const moves = parse_numbers(commas);
+
+  if (!moves)
+  {
+    return std::nullopt;
+  }
+
+  auto route = route_t{};
+  route.assign(std::begin(moves.value()), std::end(moves.value()));
+
+  return route;
+}
+
 } // namespace pnkd
@@ -1,241 +1,359 @@
 #include "game/state.hpp"
 
-#include <cmath>
+#include <algorithm>
 #include <numeric>
 #include <optional>
+#include <utility>
 #include <spdlog/spdlog.h>
 
 #include "game/point.hpp"
+#include "utils/bit_utils.hpp"
 #include "utils/string_utils.hpp"
 
 namespace pnkd
 {
 
-auto const is_perfect_square = [](std::size_t const n) {
-  // Ignore empty grids
-  if (n == 0)
-  {
-    return false;
-  }
-
-  std::size_t const sqrt = std::sqrt(n);
-
-  return (sqrt * sqrt == n);
-};
-
-
-game_state_t::game_state_t(grid_t const &grid, goal_list_t const &goals, std::size_t const buffer_size) : m_grid(grid), m_grid_size(grid.size()), m_goal_list(goals), m_buffer_size(buffer_size), m_pos(point_t{grid.size()}), m_direction(false) //, m_move_history(move_history_t{}), m_route(route_t{})
+game_state_t::game_state_t(grid_t const &grid, goal_list_t const &goals, std::size_t const buffer_size) : game_state_t(std::make_shared<puzzle_t const>(grid, goals, buffer_size))
 {
-  std::size_t const grid_size = grid.size();
-
-  // We expect grids that are perfect squares
-  if (!is_perfect_square(grid_size))
-  {
-    spdlog::error("Invalid grid size: {}", grid_size);
-  }
-
-  this->m_grid_width = static_cast<std::size_t>(std::sqrt(grid_size));
-
-  //spdlog::debug("Created game_state_t for a {}x{} ({}) grid with {} goals and a buffer size of {}", grid_width, grid_width, grid_size, goals.size(), buffer_size);
 }
 
 
-game_state_t::game_state_t(grid_t const &grid, goal_list_t const &goals, std::size_t const buffer_size, point_t const &pos, bool const direction, move_history_t const &move_history, route_t const &route) : m_grid(grid), m_grid_size(grid.size()), m_goal_list(goals), m_buffer_size(buffer_size), m_pos(pos), m_direction(direction), m_move_history(move_history), m_route(route)
+game_state_t::game_state_t(std::shared_ptr<puzzle_t const> puzzle) : m_puzzle(std::move(puzzle))
 {
-  std::size_t const grid_size = grid.size();
+  // Nothing has been moved into yet, so only the starting position and goal progress contribute to the hash
+  this->m_hash = this->m_puzzle->position_key(this->m_pos);
 
-  // We expect grids that are perfect squares
-  if (!is_perfect_square(grid_size))
+  for (std::size_t i = 0; i < this->m_puzzle->num_goals(); ++i)
   {
-    spdlog::error("Invalid grid size: {}", grid_size);
+    // Any goal longer than the whole buffer is out of reach from the start
+    this->m_progress = set_progress_code(this->m_progress, i, this->m_puzzle->reachable_progress_code(i, 0, this->m_puzzle->buffer_size()));
+    this->m_hash ^= this->m_puzzle->goal_key(i, progress_code(this->m_progress, i));
   }
+}
 
-  this->m_grid_width = static_cast<std::size_t>(std::sqrt(grid_size));
 
-  //spdlog::debug("Created game_state_t for a {}x{} ({}) grid with {} goals and a buffer size of {}", grid_width, grid_width, grid_size, goals.size(), buffer_size);
+game_state_t::game_state_t(std::shared_ptr<puzzle_t const> puzzle, goal_progress_t const progress, std::uint64_t const completed_in, std::size_t const pos, bool const direction, cell_mask_t const move_history, std::uint64_t const hash)
+  : m_puzzle(std::move(puzzle)), m_progress(progress), m_completed_in(completed_in), m_pos(static_cast<std::uint8_t>(pos)), m_direction(direction), m_move_history(move_history), m_hash(hash)
+{
 }
 
 
 auto game_state_t::is_valid_move(std::size_t const pos) const -> bool
 {
   // If the bit at index pos is set, then that means we've already move there, so return false
-  return !this->m_move_history.test(pos);
+  return ((this->m_move_history >> pos) & 1U) == 0;
 }
 
 
-auto game_state_t::list_all_valid_moves() const -> std::vector<std::size_t>
+auto game_state_t::valid_moves() const -> cell_mask_t
 {
-  // How many moves have we made already?
-  auto const moves_taken = this->moves_taken(); //this->m_move_history.count();
-
   // Have we already made all our moves?
-  if (moves_taken >= this->m_buffer_size)
+  if (this->moves_taken() >= this->m_puzzle->buffer_size())
   {
     spdlog::debug("Can't take any more moves!");
-    return std::vector<std::size_t>{};
+    return 0;
   }
 
-  auto valid_moves = std::vector<std::size_t>{};
-
-  // Where are we currently?
-  auto const [col, row] = this->m_pos.col_row();
+  // Every cell in the same row or column that we haven't already moved into
+  return this->valid_moves(this->m_puzzle->board());
+}
 
-  // Check all possible positions in the same row or column
-  for (std::size_t i = 0; i < this->m_grid_width; ++i)
-  {
-    std::size_t next_pos = 0;
 
-    if (this->m_direction)
-    {
-      //spdlog::info("Moving vertically - col: {} row: {} g_w: {}, ", col, i, this->m_grid_width);
-      next_pos = pnkd::point_t::xy_to_pos(col, i, this->m_grid_width);
-    } else
-    {
-      //spdlog::info("Moving horizontally - col: {} row: {} g_w: {}, ", col, i, this->m_grid_width);
-      next_pos = pnkd::point_t::xy_to_pos(i, row, this->m_grid_width);
-    }
+auto game_state_t::list_all_valid_moves() const -> std::vector<std::size_t>
+{
+  auto valid_moves = std::vector<std::size_t>{};
 
-    if (this->is_valid_move(next_pos))
-    {
-      valid_moves.push_back(next_pos);
-    }
+  for (cell_mask_t moves = this->valid_moves(); moves != 0; moves &= moves - 1)
+  {
+    valid_moves.push_back(count_trailing_zeros(moves));
   }
 
   return valid_moves;
 }
 
 
-auto game_state_t::score_goals(std::size_t const move) const -> goal_list_t
+auto game_state_t::make_move(std::size_t const move) const -> std::optional<game_state_t>
 {
-  auto goal_list = this->m_goal_list;
+  auto const &puzzle = *this->m_puzzle;
 
-  std::string const s = this->m_grid[move];
+  // Get copies of the current state variables
+  auto move_history = this->m_move_history;
+  bool direction = this->m_direction;
 
-  for (std::size_t i = 0; i < goal_list.size(); ++i)
-  {
-    // Only bother with goals we haven't finished yet
-    if (!goal_list[i].empty())
-    {
-      if (s == goal_list[i].front())
-      {
-        spdlog::debug("{} @ {} is the next sequence in the goal '{}'! {} of {} done", s, point_t{move, this->m_grid_size}, goal_list[i].str(), goal_list[i].seq_len() - (goal_list[i].size() - 1), goal_list[i].seq_len());
-        goal_list[i].pop();
+  // Make the move
+  move_history |= cell_mask_t{1} << move; // Mark this position as moved into
+  direction = !direction; // Toggle the vertical direction flag
 
-        // Was that the last sequence? If so, mark it as complete
-        if (goal_list[i].empty())
-        {
-          spdlog::debug("{} was the last sequence in the goal '{}', so it's now complete! Nice!", s, goal_list[i].str());
-          //goal_list[i].m_completed = true;
-          goal_list[i].completed_in(this->moves_taken() + 1); // +1 because at this point the current move is still being evaluated, so the number returned by this->moves_taken() is 1 behind
-          goal_list.complete_one();
-        }
+  // Update the hash with everything that changed
+  std::uint64_t hash = this->m_hash;
+  hash ^= puzzle.history_key(move);
+  hash ^= puzzle.position_key(this->m_pos) ^ puzzle.position_key(move);
+  hash ^= puzzle.direction_key();
 
-        goal_list[i].m_progress.set(i);
+  // Now check if it progressed any goals - each one only needs a lookup in the puzzle's transition table
+  symbol_t const symbol = puzzle.cell(move);
+  std::size_t const moves_taken = count_bits(move_history);
+  std::size_t const moves_left = puzzle.buffer_size() - moves_taken;
 
-      } else
-      {
-        // If this square DIDN'T match the goal sequence, check that we haven't already started it, otherwise it's a bust
-        if (goal_list[i].size() != goal_list[i].seq_len())
-        {
-          spdlog::debug("Looks like we had already begun goal sequence {} '{}' so have now failed it! Doh!", i, goal_list[i].str());
-          goal_list[i].m_failed = true;
+  goal_progress_t progress = this->m_progress;
+  std::uint64_t completed_in = this->m_completed_in;
 
-          // Empty the failed goal out so we don't keep checking it
-          while (!goal_list[i].empty())
-          {
-            goal_list[i].pop();
-          }
+  for (std::size_t i = 0; i < puzzle.num_goals(); ++i)
+  {
+    std::uint8_t const before = progress_code(progress, i);
+    std::uint8_t const after = puzzle.reachable_progress_code(i, puzzle.next_progress_code(i, before, symbol), moves_left);
 
-          goal_list.fail_one();
+    if (before != after)
+    {
+      progress = set_progress_code(progress, i, after);
+      hash ^= puzzle.goal_key(i, before) ^ puzzle.goal_key(i, after);
 
-          spdlog::debug("{} goals remaining", goal_list.remaining());
-        }
+      // Was that the last sequence? If so, remember when it was completed
+      if (after == puzzle.goal_length(i))
+      {
+        spdlog::debug("{} @ {} was the last sequence in goal {}, so it's now complete! Nice!", puzzle.grid()[move], move, i);
+        completed_in |= std::uint64_t{moves_taken} << (8 * i);
       }
     }
   }
 
-  spdlog::debug("After moving to {} @ {}, {} goals remain of {} ({} successfully completed)", s, pnkd::point_t{move, this->m_grid_size}, goal_list.remaining(), goal_list.total(), goal_list.completed());
+  // Have we failed all the goals?
+  if (progress == puzzle.all_failed())
+  {
+    spdlog::debug("All goals failed after moving to {} from state #{}!", move, this->m_id);
 
-  return goal_list;
+    return std::nullopt;
+  }
+
+  // Now create a new game state based on the move we just made
+  // The puzzle itself is shared rather than copied, so only the per-path data is duplicated
+  auto new_state = pnkd::game_state_t{this->m_puzzle, progress, completed_in, move, direction, move_history, hash};
+  new_state.m_parent_id = this->m_id;
+
+  return new_state;
 }
 
 
-auto game_state_t::make_move(std::size_t const move) const -> std::optional<game_state_t>
+auto game_state_t::replay(route_t const &moves) const -> std::optional<game_state_t>
 {
-  // Get copies of the current state variables
-  auto move_history = this->m_move_history;
+  auto game_state = *this;
   auto route = this->m_route;
-  bool direction = this->m_direction;
 
-  // Make the move
-  move_history.set(move); // Mark this position as moved into
-  route.push_back(move);  // Add the move to the route history
-  direction = !direction; // Toggle the vertical direction flag
+  for (std::size_t const move : moves)
+  {
+    // Is it on the right row (or column), and somewhere we haven't already been?
+    if (move >= this->m_puzzle->grid_size() || ((game_state.valid_moves() >> move) & 1U) == 0)
+    {
+      spdlog::error("Can't move to {} after {}!", move, route.empty() ? std::string{"starting"} : route.str());
+      return std::nullopt;
+    }
 
-  // Now check if it progressed any goals
-  auto new_goals = this->score_goals(move);
+    auto next_game_state = game_state.make_move(move);
 
-  // Have we failed all the goals?
-  if (new_goals.remaining() == 0 && new_goals.completed() == 0)
-  {
-    spdlog::debug("All goals failed! Route taken: {}", route);
+    if (!next_game_state)
+    {
+      spdlog::error("Moving to {} after {} fails every goal!", move, route.empty() ? std::string{"starting"} : route.str());
+      return std::nullopt;
+    }
 
-    return std::nullopt;
+    game_state = next_game_state.value();
+    route.push_back(move);
   }
 
-  // Create a new point_t for the new position
-  auto new_pos = point_t{move, this->m_grid_size};
+  game_state.set_route(route);
 
-  // Now create a new game state based on the move we just made
-  auto new_state = pnkd::game_state_t{this->m_grid, new_goals, this->m_buffer_size, new_pos, direction, move_history, route};
+  return game_state;
+}
 
-  return new_state;
+
+auto game_state_t::puzzle() const -> puzzle_t const &
+{
+  return *this->m_puzzle;
 }
 
+auto game_state_t::pos() const -> point_t
+{
+  return point_t{this->m_pos, this->m_puzzle->grid_size()};
+}
 
-auto game_state_t::pos() const -> point_t const &
+auto game_state_t::position() const -> std::size_t
 {
   return this->m_pos;
 }
 
+auto game_state_t::direction() const -> bool
+{
+  return this->m_direction;
+}
+
+auto game_state_t::move_history() const -> cell_mask_t
+{
+  return this->m_move_history;
+}
+
 auto game_state_t::route() const -> route_t const &
 {
   return this->m_route;
 }
 
+auto game_state_t::proven() const -> bool
+{
+  return this->m_proven;
+}
+
 auto game_state_t::grid() const -> grid_t const &
 {
-  return this->m_grid;
+  return this->m_puzzle->grid();
 }
 
 auto game_state_t::goals() const -> goal_list_t const &
 {
-  return this->m_goal_list;
+  // Fill in a copy of the puzzle's goals with how far along each one is
+  if (!this->m_goal_list)
+  {
+    auto goal_list = this->m_puzzle->goals();
+
+    for (std::size_t i = 0; i < goal_list.size(); ++i)
+    {
+      auto &goal = goal_list[i];
+      std::uint8_t const code = progress_code(this->m_progress, i);
+
+      if (code > goal.seq_len())
+      {
+        goal.fail();
+        goal_list.fail_one();
+      } else
+      {
+        goal.m_matched = code;
+
+        if (code == goal.seq_len())
+        {
+          goal.completed_in(progress_code(this->m_completed_in, i));
+          goal_list.complete_one();
+        }
+      }
+    }
+
+    this->m_goal_list = goal_list;
+  }
+
+  return this->m_goal_list.value();
+}
+
+auto game_state_t::is_terminal() const -> bool
+{
+  // Goals that can't fit in the moves left have already been failed, so if every goal is either completed or failed then
+  // nothing after this can change the outcome (and that includes running out of moves)
+  for (std::size_t i = 0; i < this->m_puzzle->num_goals(); ++i)
+  {
+    if (progress_code(this->m_progress, i) < this->m_puzzle->goal_length(i))
+    {
+      return false;
+    }
+  }
+
+  return true;
 }
 
 auto game_state_t::moves_taken() const -> std::size_t
 {
-  return this->m_move_history.count();
+  return count_bits(this->m_move_history);
+}
+
+auto game_state_t::scoring_moves() const -> std::size_t
+{
+  // The number of moves it took to complete the last of our completed goals - any moves after that are just filler
+  std::size_t scoring_moves = 0;
+
+  for (std::size_t i = 0; i < this->m_puzzle->num_goals(); ++i)
+  {
+    scoring_moves = std::max<std::size_t>(scoring_moves, progress_code(this->m_completed_in, i));
+  }
+
+  return scoring_moves;
+}
+
+auto game_state_t::goal_combo() const -> std::size_t
+{
+  // Bit n is set if goal n has been completed
+  std::size_t combo = 0;
+
+  for (std::size_t i = 0; i < this->m_puzzle->num_goals(); ++i)
+  {
+    if (progress_code(this->m_progress, i) == this->m_puzzle->goal_length(i))
+    {
+      combo |= std::size_t{1} << i;
+    }
+  }
+
+  return combo;
+}
+
+auto game_state_t::goals_completed() const -> std::size_t
+{
+  return count_bits(this->goal_combo());
+}
+
+auto game_state_t::goal_remaining(std::size_t const goal) const -> std::size_t
+{
+  // Completed and failed goals have nothing left to match
+  std::size_t const code = progress_code(this->m_progress, goal);
+  std::size_t const length = this->m_puzzle->goal_length(goal);
+
+  return code < length ? length - code : 0;
 }
 
 auto game_state_t::buffer_size() const -> std::size_t
 {
-  return this->m_buffer_size;
+  return this->m_puzzle->buffer_size();
 }
 
-auto game_state_t::id() const -> std::string const &
+auto game_state_t::id() const -> state_id_t
 {
   return this->m_id;
 }
 
-auto game_state_t::parent_id() const -> std::string const &
+auto game_state_t::parent_id() const -> state_id_t
 {
   return this->m_parent_id;
 }
 
-auto game_state_t::set_parent_id(std::string const &id) -> void
+auto game_state_t::progress() const -> goal_progress_t
+{
+  return this->m_progress;
+}
+
+auto game_state_t::key() const -> state_key_t
+{
+  return state_key_t{this->m_hash, this->m_move_history, this->m_progress, this->m_pos, this->m_direction};
+}
+
+auto game_state_t::pack() const -> packed_state_t
+{
+  return packed_state_t{this->m_progress, this->m_completed_in, this->m_move_history, this->m_hash, this->m_id, this->m_pos, this->m_direction};
+}
+
+auto game_state_t::unpack(packed_state_t const &packed) const -> game_state_t
+{
+  auto game_state = game_state_t{this->m_puzzle, packed.m_progress, packed.m_completed_in, packed.m_pos, packed.m_direction, packed.m_move_history, packed.m_hash};
+  game_state.m_id = packed.m_id;
+
+  return game_state;
+}
+
+auto game_state_t::set_id(state_id_t const id) -> void
+{
+  this->m_id = id;
+}
+
+auto game_state_t::set_route(route_t const &route) -> void
+{
+  this->m_route = route;
+}
+
+auto game_state_t::set_proven(bool const proven) -> void
 {
-  this->m_parent_id = id;
+  this->m_proven = proven;
 }
 
 } // namespace pnkd
@@ -0,0 +1,74 @@
+#include "game/symbol.hpp"
+
+#include <algorithm>
+
+#include <spdlog/spdlog.h>
+
+namespace pnkd
+{
+
+auto alphabet_t::intern(std::string const &code) -> symbol_t
+{
+  // Have we seen this code before?
+  symbol_t const existing = this->find(code);
+
+  if (existing != invalid_symbol)
+  {
+    return existing;
+  }
+
+  // There are only a handful of codes in the real game, so this should never happen unless the OCR has gone badly wrong
+  if (this->m_codes.size() >= max_symbols)
+  {
+    spdlog::error("Too many distinct codes to intern '{}'!", code);
+    return invalid_symbol;
+  }
+
+  this->m_codes.push_back(code);
+
+  return static_cast<symbol_t>(this->m_codes.size() - 1);
+}
+
+auto alphabet_t::intern(std::vector<std::string> const &codes) -> symbol_seq_t
+{
+  auto symbols = symbol_seq_t{};
+  symbols.reserve(codes.size());
+
+  for (auto const &code : codes)
+  {
+    symbols.push_back(this->intern(code));
+  }
+
+  return symbols;
+}
+
+auto alphabet_t::find(std::string const &code) const -> symbol_t
+{
+  auto const it = std::find(std::begin(this->m_codes), std::end(this->m_codes), code);
+
+  if (it == std::end(this->m_codes))
+  {
+    return invalid_symbol;
+  }
+
+  return static_cast<symbol_t>(std::distance(std::begin(this->m_codes), it));
+}
+
+auto alphabet_t::code(symbol_t const symbol) const -> std::string const &
+{
+  static auto const unknown = std::string{"??"};
+
+  if (symbol >= this->m_codes.size())
+  {
+    return unknown;
+  }
+
+  return this->m_codes[symbol];
+}
+
+auto alphabet_t::size() const -> std::size_t
+{
+  return this->m_codes.size();
+}
+
+} // namespace pnkd
@@ -1,5 +1,10 @@
+#include <algorithm>
 #include <filesystem>
+#include <future>
+#include <map>
+#include <optional>
 #include <sstream>
+#include <stdexcept>
 #include <queue>
 
 #include <thread>
@@ -16,13 +21,223 @@
 
 #include "game/state.hpp"
 #include "game/goal.hpp"
+#include "game/route.hpp"
 
+#include "utils/cancellation.hpp"
 #include "utils/file_utils.hpp"
 #include "utils/string_utils.hpp"
 
 
 using namespace std::chrono_literals;
 
+namespace
+{
+
+// Everything the user asked for that applies to every screenshot
+struct settings_t
+{
+  std::string m_tessdata_dir;
+  std::size_t m_buffer_size;
+  std::size_t m_max_buffer_size; // Also find out what every bigger buffer up to this would unlock
+  pnkd::search_strategy_t m_strategy;
+  std::size_t m_threads;
+  long m_deadline_ms;
+  std::size_t m_alternatives; // How many routes to show for each combination of goals
+  std::size_t m_beam_width;
+  std::optional<std::vector<std::size_t>> m_weights; // What each goal is worth, if we only want the route worth the most. Empty to go by their order
+  bool m_hide_dominated; // Leave out routes that another route beats by completing the same goals and more
+};
+
+
+// Reads the puzzle from the screenshot and solves it from the moves already made, giving up part way through if it's
+// cancelled. Returns false if the screenshot couldn't be read
+auto solve_screenshot(std::filesystem::path const &image_path, settings_t const &settings, pnkd::route_t const &prefix, pnkd::cancellation_token_t const &cancel) -> bool
+{
+  auto const start = std::chrono::high_resolution_clock::now();
+
+  spdlog::info("----------------------------");
+  spdlog::info("Processing new screenshot: {}", std::filesystem::absolute(image_path).string());
+
+  // Load the image
+  cv::Mat img = cv::imread(image_path.string(), cv::IMREAD_COLOR);
+
+  // Did we successfully load an image?
+  if (img.empty())
+  {
+    spdlog::error("Failed to load image!");
+    return false;
+  }
+
+  // OCR the grid
+  auto const grid = pnkd::get_grid_from_img(img, settings.m_tessdata_dir, cancel);
+
+  if (cancel.cancelled())
+  {
+    return true;
+  }
+
+  // Did the OCR fail?
+  if (grid.empty())
+  {
+    spdlog::error("Failed to extract any text from grid!");
+    return false;
+  }
+
+  spdlog::info("Grid:\n\n{}\n", pnkd::grid_to_string(grid));
+
+  // OCR the goals
+  auto goal_list = pnkd::get_goal_list_from_img(img, settings.m_tessdata_dir, cancel);
+
+  if (cancel.cancelled())
+  {
+    return true;
+  }
+
+  // Did the OCR fail?
+  if (goal_list.empty())
+  {
+    spdlog::error("Failed to extract any text from goals!");
+    return false;
+  }
+
+  spdlog::info("Target Sequences:\n\n{}\n", pnkd::goal_list_to_string(goal_list));
+
+  spdlog::debug("Total goals: {}", goal_list.total());
+  for (auto const &goal : goal_list)
+  {
+    spdlog::debug("{}", goal.str());
+  }
+
+  // Create our initial game state, with room for the biggest buffer we're interested in. A puzzle the solver can't
+  // represent is skipped rather than solved wrong, and we carry on watching for the next screenshot
+  auto initial_state = pnkd::game_state_t{};
+
+  try
+  {
+    initial_state = pnkd::game_state_t{grid, goal_list, std::max(settings.m_buffer_size, settings.m_max_buffer_size)};
+  } catch (std::invalid_argument const &e)
+  {
+    spdlog::error("Skipping this screenshot: {}", e.what());
+    return true;
+  }
+
+  // Pick up from wherever the player has got to. If those moves can't be made on this grid, it's most likely a new
+  // board, so solve it from the start instead
+  auto resumed_state = initial_state.replay(prefix);
+
+  if (!resumed_state)
+  {
+    spdlog::warn("Couldn't make the moves already made ({}) on this grid, so solving it from the start", prefix.str());
+    resumed_state = initial_state;
+  }
+
+  // Create a puzzler and solve
+  auto puzzler = pnkd::puzzler{resumed_state.value(), settings.m_strategy, settings.m_threads};
+  puzzler.set_beam_width(settings.m_beam_width);
+
+  // Show the first good answer as soon as there is one, and then each better one - the most goals, in the fewest moves
+  auto best_so_far = std::optional<pnkd::game_state_t>{};
+
+  puzzler.on_progress([&best_so_far, &settings](std::map<std::size_t, pnkd::game_state_t> const &solutions) {
+    for (auto const &[combo, solution] : solutions)
+    {
+      if (solution.scoring_moves() > settings.m_buffer_size)
+      {
+        continue;
+      }
+
+      if (!best_so_far || solution.goals_completed() > best_so_far->goals_completed() || (solution.goals_completed() == best_so_far->goals_completed() && solution.scoring_moves() < best_so_far->scoring_moves()))
+      {
+        best_so_far = solution;
+        spdlog::info("Best so far:");
+        pnkd::show_solution(solution);
+      }
+    }
+  });
+
+  auto const deadline = settings.m_deadline_ms > 0 ? std::optional{std::chrono::steady_clock::now() + std::chrono::milliseconds{settings.m_deadline_ms}} : std::nullopt;
+
+  if (settings.m_weights)
+  {
+    auto const weights = settings.m_weights->empty() ? pnkd::goal_weights_by_order(goal_list.total()) : settings.m_weights.value();
+    auto const best = puzzler.solve_weighted(weights, deadline, cancel);
+
+    if (cancel.cancelled())
+    {
+      return true;
+    }
+
+    if (!best)
+    {
+      spdlog::error("Couldn't weigh up {} target sequences with {} weights!", goal_list.total(), weights.size());
+      return false;
+    }
+
+    std::size_t worth = 0;
+
+    for (std::size_t i = 0; i < weights.size(); ++i)
+    {
+      worth += ((best->goal_combo() >> i) & 1U) ? weights[i] : 0;
+    }
+
+    spdlog::info("Worth {} altogether:", worth);
+    pnkd::show_solution(best.value());
+  } else if (settings.m_alternatives > 1)
+  {
+    auto const alternatives = puzzler.solve_alternatives(settings.m_alternatives, deadline, cancel);
+
+    if (cancel.cancelled())
+    {
+      return true;
+    }
+
+    pnkd::show_alternatives(alternatives);
+  } else
+  {
+    auto const table = puzzler.solve_every_buffer(deadline, cancel);
+
+    if (cancel.cancelled())
+    {
+      return true;
+    }
+
+    auto solutions = table.at(settings.m_buffer_size);
+
+    if (settings.m_hide_dominated)
+    {
+      pnkd::remove_dominated(solutions);
+    }
+
+    // TODO: Inform user of optimal solutions
+    pnkd::show_solutions(solutions);
+
+    // Everything a bigger buffer adds needs every move of it, or a smaller one would have had it already
+    for (std::size_t buffer_size = settings.m_buffer_size + 1; buffer_size <= settings.m_max_buffer_size; ++buffer_size)
+    {
+      spdlog::info("A buffer size of {} would also unlock:", buffer_size);
+
+      for (auto const &[combo, solution] : table.at(buffer_size))
+      {
+        if (solution.scoring_moves() == buffer_size)
+        {
+          pnkd::show_solution(solution);
+        }
+      }
+    }
+  }
+
+  auto const finish = std::chrono::high_resolution_clock::now();
+
+  auto const nanoseconds_taken = (finish - start);
+  auto const milliseconds_taken = std::chrono::duration<double, std::milli>(nanoseconds_taken).count();
+
+  spdlog::info("Solved in {:.0f}ms", milliseconds_taken);
+
+  return true;
+}
+
+} // namespace
+
 int main(int argc, const char **argv)
 {
   auto const args = docopt::docopt(pnkd::usage, {std::next(argv), std::next(argv, argc)},
@@ -59,6 +274,12 @@ int main(int argc, const char **argv)
   }
 
   // Get the buffer size screenshots folder
+  if (args.at("<buffer_size>").asLong() < 1)
+  {
+    spdlog::error("Need a buffer size of at least 1, not {}!", args.at("<buffer_size>").asLong());
+    return EXIT_FAILURE;
+  }
+
   std::size_t const buffer_size = static_cast<std::size_t>(args.at("<buffer_size>").asLong());
   spdlog::info("Buffer size: {}", buffer_size);
 
@@ -83,85 +304,141 @@ int main(int argc, const char **argv)
     return EXIT_FAILURE;
   }
 
-  // Start watching the screenshots folder
-  auto previous_image_path = std::filesystem::path{};
+  // Get the user-specified search strategy
+  auto const strategy = pnkd::parse_search_strategy(args.at("--strategy").asString());
 
-  while (true)
+  if (!strategy)
   {
-    auto const start = std::chrono::high_resolution_clock::now();
+    spdlog::error("Unknown search strategy '{}'! Expected bfs, dfs, best, seq or beam", args.at("--strategy").asString());
+    return EXIT_FAILURE;
+  }
 
-    auto const latest_image_path = pnkd::get_path_to_latest_screenshot(path);
+  // Get the user-specified number of threads
+  long const threads = args.at("--threads").asLong();
 
-    if (latest_image_path == previous_image_path)
-    {
-      //spdlog::info("No new images yet...");
-      std::this_thread::sleep_for(1s);
-      continue;
-    }
+  if (threads < 1)
+  {
+    spdlog::error("Need at least one thread to search with, not {}!", threads);
+    return EXIT_FAILURE;
+  }
 
-    spdlog::info("----------------------------");
-    spdlog::info("Processing new screenshot: {}", std::filesystem::absolute(latest_image_path).string());
+  // Get the user-specified time limit, if any
+  long const deadline_ms = args.at("--deadline").asLong();
 
-    // Load the latest image
-    cv::Mat img = pnkd::get_latest_screenshot(path);
+  if (deadline_ms < 0)
+  {
+    spdlog::error("Can't search for a negative amount of time ({}ms)!", deadline_ms);
+    return EXIT_FAILURE;
+  }
 
-    // Did we successfully load an image?
-    if (img.empty())
-    {
-      spdlog::error("Failed to load image!");
-      return EXIT_FAILURE; // TODO: Handle this better than just quitting
-    }
+  // Get the user-specified biggest buffer to compare against, if any
+  long const max_buffer_size = args.at("--max-buffer").asLong();
 
-    // OCR the grid
-    auto const grid = pnkd::get_grid_from_img(img, tessdata_dir);
+  if (max_buffer_size != 0 && max_buffer_size < static_cast<long>(buffer_size))
+  {
+    spdlog::error("The buffer size to compare against ({}) can't be smaller than the current one ({})!", max_buffer_size, buffer_size);
+    return EXIT_FAILURE;
+  }
 
-    // Did the OCR fail?
-    if (grid.empty())
-    {
-      spdlog::error("Failed to extract any text from grid!");
-      return EXIT_FAILURE; // TODO: Handle this better than just quitting
-    }
+  // Get the user-specified moves already made, if any
+  auto const prefix = args.at("--resume").isString() ? pnkd::parse_route(args.at("--resume").asString()) : pnkd::route_t{};
 
-    spdlog::info("Grid:\n\n{}\n", pnkd::grid_to_string(grid));
+  if (!prefix)
+  {
+    spdlog::error("Couldn't read the moves already made from '{}'! Expected cell numbers like 0,15,17", args.at("--resume").asString());
+    return EXIT_FAILURE;
+  }
 
-    // OCR the goals
-    auto goal_list = pnkd::get_goal_list_from_img(img, tessdata_dir);
+  // Get the user-specified number of routes to show for each combination of goals
+  long const alternatives = args.at("--alternatives").asLong();
 
-    // Did the OCR fail?
-    if (goal_list.empty())
-    {
-      spdlog::error("Failed to extract any text from goals!");
-      return EXIT_FAILURE; // TODO: Handle this better than just quitting
-    }
+  if (alternatives < 1)
+  {
+    spdlog::error("Need to show at least one route for each combination of goals, not {}!", alternatives);
+    return EXIT_FAILURE;
+  }
 
-    spdlog::info("Target Sequences:\n\n{}\n", pnkd::goal_list_to_string(goal_list));
+  if (alternatives > 1 && max_buffer_size != 0)
+  {
+    spdlog::error("Can't show alternative routes and compare buffer sizes at the same time!");
+    return EXIT_FAILURE;
+  }
 
-    spdlog::debug("Total goals: {}", goal_list.total());
-    for (auto const &goal : goal_list)
+  // Get the user-specified beam width
+  long const beam_width = args.at("--beam-width").asLong();
+
+  if (beam_width < 1)
+  {
+    spdlog::error("The beam needs to keep at least one route, not {}!", beam_width);
+    return EXIT_FAILURE;
+  }
+
+  // Get the user-specified weight of each goal, if any
+  auto weights = std::optional<std::vector<std::size_t>>{};
+
+  if (args.at("--weights").isString())
+  {
+    weights = args.at("--weights").asString() == "order" ? std::optional{std::vector<std::size_t>{}} : pnkd::parse_numbers(args.at("--weights").asString());
+
+    if (!weights)
     {
-      spdlog::debug("{}", goal.str());
+      spdlog::error("Couldn't read the weights from '{}'! Expected one for each target sequence like 1,2,5, or order", args.at("--weights").asString());
+      return EXIT_FAILURE;
     }
 
-    // Create our initial game state
-    auto const initial_state = pnkd::game_state_t{grid, goal_list, buffer_size};
+    if (alternatives > 1 || max_buffer_size != 0)
+    {
+      spdlog::error("Can't only show the route worth the most and show alternatives or compare buffer sizes at the same time!");
+      return EXIT_FAILURE;
+    }
+  }
 
-    // Create a puzzler and solve
-    auto puzzler = pnkd::puzzler{initial_state};
-    auto const solutions = puzzler.solve();
+  auto const settings = settings_t{tessdata_dir, buffer_size, static_cast<std::size_t>(max_buffer_size), strategy.value(), static_cast<std::size_t>(threads), deadline_ms, static_cast<std::size_t>(alternatives), static_cast<std::size_t>(beam_width), weights, args.at("--hide-dominated").asBool()};
 
-    // TODO: Inform user of optimal solutions
-    pnkd::show_solutions(solutions);
+  // The moves already made only apply to the board on screen right now, so only the first screenshot is resumed from
+  auto next_prefix = prefix.value();
 
-    auto const finish = std::chrono::high_resolution_clock::now();
+  // Start watching the screenshots folder
+  auto previous_image_path = std::filesystem::path{};
+  auto cancel = pnkd::cancellation_token_t{};
+  auto job = std::future<bool>{};
 
-    auto const nanoseconds_taken = (finish - start);
-    auto const milliseconds_taken = std::chrono::duration<double, std::milli>(nanoseconds_taken).count();
+  while (true)
+  {
+    auto const latest_image_path = pnkd::get_path_to_latest_screenshot(path);
 
-    spdlog::info("Solved in {:.0f}ms", milliseconds_taken);
+    if (latest_image_path != previous_image_path)
+    {
+      // A newer screenshot means the puzzle we're still working on is out of date, so drop it
+      if (job.valid())
+      {
+        spdlog::info("Dropping the previous screenshot for a newer one...");
+        cancel.cancel();
+
+        if (!job.get())
+        {
+          return EXIT_FAILURE; // TODO: Handle this better than just quitting
+        }
+      }
+
+      cancel = pnkd::cancellation_token_t{};
+      job = std::async(std::launch::async, solve_screenshot, latest_image_path, std::cref(settings), next_prefix, cancel);
+      next_prefix.clear();
+      previous_image_path = latest_image_path;
+    }
 
-    previous_image_path = latest_image_path;
+    if (!job.valid())
+    {
+      //spdlog::info("No new images yet...");
+      std::this_thread::sleep_for(1s); // Give it a second before checking for new screenshots, to avoid hammering the CPU
+      continue;
+    }
 
-    std::this_thread::sleep_for(1s); // Give it a second before checking for new screenshots, to avoid hammering the CPU
+    // Keep an eye out for newer screenshots while the current one is being solved
+    if (job.wait_for(100ms) == std::future_status::ready && !job.get())
+    {
+      return EXIT_FAILURE; // TODO: Handle this better than just quitting
+    }
   }
 
   return EXIT_SUCCESS;
@@ -1,7 +1,9 @@
 #include "utils/string_utils.hpp"
 
 #include <algorithm>
+#include <charconv>
 #include <sstream>
+#include <system_error>
 
 #include <spdlog/spdlog.h>
 
@@ -47,6 +49,30 @@ auto split(std::string const &input, std::string const &delimiters) -> std::vect
 }
 
 
+auto parse_numbers(std::string const &input) -> std::optional<std::vector<std::size_t>>
+{
+  auto numbers = std::vector<std::size_t>{};
+
+  for (auto const &segment : split(input, ","))
+  {
+    auto const field = strip(segment);
+
+    // Every field has to be a whole number, and nothing else - not even a sign. An empty one means a number is missing
+    std::size_t number = 0;
+    auto const [end, error] = std::from_chars(field.data(), field.data() + field.size(), number);
+
+    if (field.empty() || error != std::errc{} || end != field.data() + field.size())
+    {
+      return std::nullopt;
+    }
+
+    numbers.push_back(number);
+  }
+
+  return numbers;
+}
+
+
 auto grid_to_string(std::vector<std::string> const &input) -> std::string
 {
   // What is the grid width?
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace pnkd
+{
+
+// The bigger puzzles the benchmarks run on
+
+// clang-format off
+inline auto const benchmark_grid_7x7 = std::vector<std::string>{
+  "1C", "BD", "BD", "1C", "BD", "E9", "55",
+  "E9", "55", "E9", "55", "BD", "BD", "1C",
+  "BD", "1C", "E9", "55", "BD", "1C", "55",
+  "BD", "55", "55", "1C", "BD", "55", "BD",
+  "55", "BD", "55", "55", "1C", "E9", "1C",
+  "7A", "1C", "BD", "7A", "E9", "55", "BD",
+  "E9", "7A", "55", "1C", "BD", "7A", "1C"};
+
+inline auto const benchmark_grid_8x8 = std::vector<std::string>{
+  "BD", "55", "E9", "FF", "1C", "1C", "7A", "1C",
+  "BD", "7A", "1C", "7A", "55", "1C", "1C", "E9",
+  "E9", "1C", "55", "1C", "7A", "E9", "1C", "7A",
+  "1C", "55", "FF", "FF", "7A", "1C", "7A", "7A",
+  "E9", "1C", "55", "1C", "7A", "55", "BD", "E9",
+  "55", "7A", "1C", "7A", "BD", "7A", "FF", "55",
+  "1C", "7A", "7A", "FF", "55", "BD", "1C", "7A",
+  "FF", "1C", "7A", "1C", "7A", "55", "E9", "FF"};
+
+inline auto const benchmark_goals = std::vector<std::vector<std::string>>{
+  {"7A", "E9"},
+  {"BD", "E9", "7A"},
+  {"E9", "BD"},
+  {"BD", "55", "55"},
+  {"FF", "55"},
+  {"1C", "7A", "BD"},
+  {"55", "1C"},
+  {"BD", "FF", "E9"}};
+// clang-format on
+
+} // namespace pnkd
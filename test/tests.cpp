@@ -1,7 +1,13 @@
 #define CATCH_CONFIG_MAIN // This tells the Catch2 header to generate a main
+#define CATCH_CONFIG_ENABLE_BENCHMARKING // Only run when asked for, with the [benchmark] tag
 
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <stdexcept>
 #include <string>
 #include <filesystem>
+#include <tuple>
 
 #include <spdlog/spdlog.h>
 #include <opencv2/opencv.hpp>
@@ -9,14 +15,21 @@
 #include "catch.hpp"
 
 #include "core/ocr.hpp"
+#include "core/oracle.hpp"
+#include "core/pruning.hpp"
 #include "core/puzzler.hpp"
+#include "core/sequencer.hpp"
+#include "core/transposition.hpp"
 
+#include "game/board.hpp"
 #include "game/goal.hpp"
+#include "game/puzzle.hpp"
 #include "game/state.hpp"
 
 #include "utils/file_utils.hpp"
 #include "utils/string_utils.hpp"
 
+#include "benchmark_corpus.hpp"
 #include "sample_image.hpp"
 
 ////////////////////////////////////////////////////////////////
@@ -128,3 +141,1333 @@ SCENARIO("Path solving", "[puzzler]")
     }
   }
 }
+
+
+////////////////////////////////////////////////////////////////
+SCENARIO("Symbol interning", "[puzzle]")
+{
+  spdlog::set_level(spdlog::level::off);
+
+  GIVEN("A 5x5 grid and a set of 2 goals")
+  {
+    // clang-format off
+    auto const test_grid = std::vector<std::string>{
+      "1C", "BD", "BD", "1C", "BD", 
+      "E9", "55", "E9", "55", "BD", 
+      "BD", "1C", "E9", "55", "BD", 
+      "BD", "55", "55", "1C", "BD", 
+      "55", "BD", "55", "55", "1C"};
+
+    auto const goals = std::vector<std::vector<std::string>>{
+      {"1C", "BD"}, 
+      {"FF", "55"}};
+    // clang-format on
+
+    WHEN(" a puzzle is built from them")
+    {
+      auto const puzzle = pnkd::puzzle_t{test_grid, pnkd::goal_list_t{goals}, 6};
+
+      THEN(" every distinct code is mapped to its own one-byte symbol")
+      {
+        REQUIRE(puzzle.alphabet().size() == 5);
+        REQUIRE(puzzle.cell(0) == puzzle.cell(3));
+        REQUIRE(puzzle.cell(0) != puzzle.cell(1));
+        REQUIRE(puzzle.alphabet().code(puzzle.cell(5)) == "E9");
+      }
+
+      THEN(" the goals are interned with the same symbols as the grid")
+      {
+        REQUIRE(puzzle.goals()[0].m_symbols == pnkd::symbol_seq_t{puzzle.cell(0), puzzle.cell(1)});
+        REQUIRE(puzzle.goals()[1].m_symbols[1] == puzzle.cell(6));
+        REQUIRE(puzzle.alphabet().find("FF") == puzzle.goals()[1].m_symbols[0]);
+      }
+    }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////
+SCENARIO("Depth-first branch-and-bound", "[puzzler]")
+{
+  spdlog::set_level(spdlog::level::off);
+
+  GIVEN("A 5x5 grid, a set of 3 goals, and a buffer size of 6")
+  {
+    // clang-format off
+    auto const test_grid = std::vector<std::string>{
+      "1C", "BD", "BD", "1C", "BD", 
+      "E9", "55", "E9", "55", "BD", 
+      "BD", "1C", "E9", "55", "BD", 
+      "BD", "55", "55", "1C", "BD", 
+      "55", "BD", "55", "55", "1C"};
+
+    auto const goals = std::vector<std::vector<std::string>>{
+      {"1C", "BD"}, 
+      {"E9", "55", "1C"}, 
+      {"55", "55", "E9"}};
+    // clang-format on
+
+    auto const initial_state = pnkd::game_state_t{test_grid, pnkd::goal_list_t{goals}, 6};
+
+    WHEN(" the puzzle is solved both breadth-first and depth-first")
+    {
+      auto bfs = pnkd::puzzler{initial_state, pnkd::search_strategy_t::breadth_first};
+      auto const bfs_solutions = bfs.solve();
+
+      auto dfs = pnkd::puzzler{initial_state, pnkd::search_strategy_t::depth_first};
+      auto const dfs_solutions = dfs.solve();
+
+      THEN(" both find the same combinations of goals in the same number of moves")
+      {
+        REQUIRE(dfs_solutions.size() == bfs_solutions.size());
+
+        for (auto const &[combo, solution] : bfs_solutions)
+        {
+          REQUIRE(dfs_solutions.count(combo) == 1);
+          REQUIRE(dfs_solutions.at(combo).scoring_moves() == solution.scoring_moves());
+          REQUIRE(dfs_solutions.at(combo).route().size() == dfs_solutions.at(combo).moves_taken());
+        }
+      }
+    }
+
+    WHEN(" every route is tried, and the puzzle is solved with each strategy")
+    {
+      // The fewest moves any route takes to complete exactly each combination of goals
+      auto fewest_moves = std::map<std::size_t, std::size_t>{};
+
+      auto const walk = [&fewest_moves](auto const &self, pnkd::game_state_t const &game_state) -> void {
+        for (std::size_t const move : game_state.list_all_valid_moves())
+        {
+          auto const next_game_state = game_state.make_move(move);
+
+          if (next_game_state)
+          {
+            if (next_game_state->goal_combo() != game_state.goal_combo())
+            {
+              auto const [it, added] = fewest_moves.emplace(next_game_state->goal_combo(), next_game_state->scoring_moves());
+              it->second = std::min(it->second, next_game_state->scoring_moves());
+            }
+
+            self(self, next_game_state.value());
+          }
+        }
+      };
+
+      walk(walk, initial_state);
+
+      auto const strategy = GENERATE(pnkd::search_strategy_t::breadth_first, pnkd::search_strategy_t::depth_first, pnkd::search_strategy_t::sequence_first);
+      auto const solutions = pnkd::puzzler{initial_state, strategy}.solve();
+
+      THEN(" every combination gets its own best route, even if another route completes more goals in as few moves")
+      {
+        REQUIRE(solutions.size() == fewest_moves.size());
+
+        for (auto const &[combo, moves] : fewest_moves)
+        {
+          REQUIRE(solutions.count(combo) == 1);
+          REQUIRE(solutions.at(combo).scoring_moves() == moves);
+        }
+      }
+    }
+  }
+
+  GIVEN("A puzzle where the quickest way to complete one goal on its own is slower than completing it along with another")
+  {
+    // Every route starts on the top row, so the only 55 straight after a 1C completes both goals at once
+    // clang-format off
+    auto const test_grid = std::vector<std::string>{
+      "1C", "1C", "1C", "1C",
+      "55", "BD", "BD", "BD",
+      "BD", "BD", "BD", "BD",
+      "BD", "BD", "BD", "BD"};
+
+    auto const goals = std::vector<std::vector<std::string>>{
+      {"1C", "55"},
+      {"55"}};
+    // clang-format on
+
+    auto const initial_state = pnkd::game_state_t{test_grid, pnkd::goal_list_t{goals}, 4};
+
+    WHEN(" the puzzle is solved with each strategy")
+    {
+      auto const strategy = GENERATE(pnkd::search_strategy_t::breadth_first, pnkd::search_strategy_t::depth_first, pnkd::search_strategy_t::sequence_first);
+      auto const solutions = pnkd::puzzler{initial_state, strategy}.solve();
+
+      THEN(" the second goal on its own still gets a route, even though completing both takes fewer moves")
+      {
+        REQUIRE(solutions.size() == 2);
+        REQUIRE(solutions.at(0b11).scoring_moves() == 2);
+        REQUIRE(solutions.at(0b10).scoring_moves() == 3);
+      }
+
+      THEN(" it's only left out when asked for")
+      {
+        auto undominated = solutions;
+        pnkd::remove_dominated(undominated);
+
+        REQUIRE(undominated.size() == 1);
+        REQUIRE(undominated.count(0b11) == 1);
+      }
+    }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////
+SCENARIO("Transposition table", "[puzzler]")
+{
+  spdlog::set_level(spdlog::level::off);
+
+  GIVEN("A 5x5 grid, a set of 3 goals, and a buffer size of 6")
+  {
+    // clang-format off
+    auto const test_grid = std::vector<std::string>{
+      "1C", "BD", "BD", "1C", "BD", 
+      "E9", "55", "E9", "55", "BD", 
+      "BD", "1C", "E9", "55", "BD", 
+      "BD", "55", "55", "1C", "BD", 
+      "55", "BD", "55", "55", "1C"};
+
+    auto const goals = std::vector<std::vector<std::string>>{
+      {"1C", "BD"}, 
+      {"E9", "55", "1C"}, 
+      {"55", "55", "E9"}};
+    // clang-format on
+
+    auto const initial_state = pnkd::game_state_t{test_grid, pnkd::goal_list_t{goals}, 6};
+
+    auto const play = [&initial_state](std::vector<std::size_t> const &moves) {
+      auto state = initial_state;
+
+      for (std::size_t const move : moves)
+      {
+        state = state.make_move(move).value();
+      }
+
+      return state;
+    };
+
+    WHEN(" two different routes visit the same cells, end in the same place and make the same goal progress")
+    {
+      auto const first = play({0, 10, 11, 1, 3, 13});
+      auto const second = play({1, 11, 10, 0, 3, 13});
+      auto const different = play({0, 10, 11, 1, 3, 8});
+
+      THEN(" they have the same key")
+      {
+        REQUIRE(first.key() == second.key());
+        REQUIRE(!(first.key() == different.key()));
+      }
+
+      THEN(" the transposition table only accepts the first of them")
+      {
+        auto table = pnkd::transposition_table_t{};
+
+        REQUIRE(table.insert(first.key()) == true);
+        REQUIRE(table.insert(second.key()) == false);
+        REQUIRE(table.insert(different.key()) == true);
+        REQUIRE(table.hits() == 1);
+      }
+    }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////
+SCENARIO("Dominance pruning", "[puzzler]")
+{
+  spdlog::set_level(spdlog::level::off);
+
+  GIVEN("A 5x5 grid, a set of 3 goals, and a buffer size of 7")
+  {
+    // clang-format off
+    auto const test_grid = std::vector<std::string>{
+      "1C", "BD", "BD", "1C", "BD", 
+      "E9", "55", "E9", "55", "BD", 
+      "BD", "1C", "E9", "55", "BD", 
+      "BD", "55", "55", "1C", "BD", 
+      "55", "BD", "55", "55", "1C"};
+
+    auto const goals = std::vector<std::vector<std::string>>{
+      {"1C", "BD"}, 
+      {"E9", "55", "1C"}, 
+      {"55", "55", "E9"}};
+    // clang-format on
+
+    auto const initial_state = pnkd::game_state_t{test_grid, pnkd::goal_list_t{goals}, 7};
+
+    // Every state the puzzle can reach
+    auto every_state = std::vector<pnkd::game_state_t>{};
+
+    auto const walk = [&every_state](auto const &self, pnkd::game_state_t const &game_state) -> void {
+      for (std::size_t const move : game_state.list_all_valid_moves())
+      {
+        auto const next_game_state = game_state.make_move(move);
+
+        if (next_game_state)
+        {
+          every_state.push_back(next_game_state.value());
+          self(self, next_game_state.value());
+        }
+      }
+    };
+
+    walk(walk, initial_state);
+
+    WHEN(" every state is run through a dominance stage with room for only a few groups")
+    {
+      auto stage = pnkd::dominance_stage_t{16};
+      std::size_t most_groups = 0;
+
+      for (auto const &game_state : every_state)
+      {
+        stage.admit(game_state);
+        most_groups = std::max(most_groups, stage.size());
+      }
+
+      THEN(" it never remembers more groups than it has room for")
+      {
+        REQUIRE(every_state.size() > 16);
+        REQUIRE(stage.capacity() <= 16);
+        REQUIRE(most_groups <= stage.capacity());
+      }
+    }
+
+    WHEN(" every state is run through a dominance stage with the default room")
+    {
+      auto stage = pnkd::dominance_stage_t{};
+
+      for (auto const &game_state : every_state)
+      {
+        stage.admit(game_state);
+      }
+
+      THEN(" it stops growing at the default size, and prunes the states it can")
+      {
+        REQUIRE(stage.capacity() <= pnkd::dominance_stage_t::default_max_groups);
+        REQUIRE(stage.size() <= stage.capacity());
+        REQUIRE(stage.removed() > 0);
+      }
+    }
+
+    WHEN(" the puzzle is solved with the dominance stage, with a tiny one, and without one")
+    {
+      auto const strategy = GENERATE(pnkd::search_strategy_t::breadth_first, pnkd::search_strategy_t::depth_first);
+
+      auto const solutions = pnkd::puzzler{initial_state, strategy}.solve();
+
+      auto tiny = pnkd::puzzler{initial_state, strategy};
+      tiny.clear_pruning_stages();
+      tiny.add_pruning_stage(std::make_unique<pnkd::transposition_stage_t>());
+      tiny.add_pruning_stage(std::make_unique<pnkd::dominance_stage_t>(16));
+      auto const tiny_solutions = tiny.solve();
+
+      auto without = pnkd::puzzler{initial_state, strategy};
+      without.clear_pruning_stages();
+      without.add_pruning_stage(std::make_unique<pnkd::transposition_stage_t>());
+      auto const unpruned_solutions = without.solve();
+
+      THEN(" every search finds the same combinations of goals in the same number of moves")
+      {
+        REQUIRE(!unpruned_solutions.empty());
+
+        for (auto const *pruned : {&solutions, &tiny_solutions})
+        {
+          REQUIRE(pruned->size() == unpruned_solutions.size());
+
+          for (auto const &[combo, solution] : unpruned_solutions)
+          {
+            REQUIRE(pruned->count(combo) == 1);
+            REQUIRE(pruned->at(combo).scoring_moves() == solution.scoring_moves());
+          }
+        }
+      }
+    }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////
+SCENARIO("Parallel branch-and-bound", "[puzzler]")
+{
+  spdlog::set_level(spdlog::level::off);
+
+  GIVEN("A 5x5 grid, a set of 3 goals, and a buffer size of 8")
+  {
+    // clang-format off
+    auto const test_grid = std::vector<std::string>{
+      "1C", "BD", "BD", "1C", "BD", 
+      "E9", "55", "E9", "55", "BD", 
+      "BD", "1C", "E9", "55", "BD", 
+      "BD", "55", "55", "1C", "BD", 
+      "55", "BD", "55", "55", "1C"};
+
+    auto const goals = std::vector<std::vector<std::string>>{
+      {"1C", "BD"}, 
+      {"E9", "55", "1C"}, 
+      {"55", "55", "E9"}};
+    // clang-format on
+
+    auto const initial_state = pnkd::game_state_t{test_grid, pnkd::goal_list_t{goals}, 8};
+
+    WHEN(" the puzzle is solved on one thread and on several")
+    {
+      auto single = pnkd::puzzler{initial_state, pnkd::search_strategy_t::depth_first};
+      auto const single_solutions = single.solve();
+
+      auto parallel = pnkd::puzzler{initial_state, pnkd::search_strategy_t::depth_first, 4};
+      auto const parallel_solutions = parallel.solve();
+
+      THEN(" both find exactly the same routes")
+      {
+        REQUIRE(parallel_solutions.size() == single_solutions.size());
+
+        for (auto const &[combo, solution] : single_solutions)
+        {
+          REQUIRE(parallel_solutions.count(combo) == 1);
+          REQUIRE(parallel_solutions.at(combo).route() == solution.route());
+        }
+      }
+    }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////
+SCENARIO("Best-first search", "[puzzler]")
+{
+  spdlog::set_level(spdlog::level::off);
+
+  GIVEN("A 5x5 grid, a set of 3 goals, and a buffer size of 8")
+  {
+    // clang-format off
+    auto const test_grid = std::vector<std::string>{
+      "1C", "BD", "BD", "1C", "BD", 
+      "E9", "55", "E9", "55", "BD", 
+      "BD", "1C", "E9", "55", "BD", 
+      "BD", "55", "55", "1C", "BD", 
+      "55", "BD", "55", "55", "1C"};
+
+    auto const goals = std::vector<std::vector<std::string>>{
+      {"1C", "BD"}, 
+      {"E9", "55", "1C"}, 
+      {"55", "55", "E9"}};
+    // clang-format on
+
+    auto const initial_state = pnkd::game_state_t{test_grid, pnkd::goal_list_t{goals}, 8};
+
+    WHEN(" the puzzle is solved best-first and depth-first")
+    {
+      auto const best_solutions = pnkd::puzzler{initial_state, pnkd::search_strategy_t::best_first}.solve();
+      auto const dfs_solutions = pnkd::puzzler{initial_state, pnkd::search_strategy_t::depth_first}.solve();
+
+      THEN(" both find exactly the same routes")
+      {
+        REQUIRE(best_solutions.size() == dfs_solutions.size());
+
+        for (auto const &[combo, solution] : dfs_solutions)
+        {
+          REQUIRE(best_solutions.count(combo) == 1);
+          REQUIRE(best_solutions.at(combo).route() == solution.route());
+        }
+      }
+    }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////
+SCENARIO("Anytime solving", "[puzzler]")
+{
+  spdlog::set_level(spdlog::level::off);
+
+  GIVEN("A 5x5 grid, a set of 3 goals, and a buffer size of 8")
+  {
+    // clang-format off
+    auto const test_grid = std::vector<std::string>{
+      "1C", "BD", "BD", "1C", "BD",
+      "E9", "55", "E9", "55", "BD",
+      "BD", "1C", "E9", "55", "BD",
+      "BD", "55", "55", "1C", "BD",
+      "55", "BD", "55", "55", "1C"};
+
+    auto const goals = std::vector<std::vector<std::string>>{
+      {"1C", "BD"},
+      {"E9", "55", "1C"},
+      {"55", "55", "E9"}};
+    // clang-format on
+
+    auto const initial_state = pnkd::game_state_t{test_grid, pnkd::goal_list_t{goals}, 8};
+    auto const strategy = GENERATE(pnkd::search_strategy_t::breadth_first, pnkd::search_strategy_t::depth_first, pnkd::search_strategy_t::best_first);
+    auto const optimal = pnkd::puzzler{initial_state, pnkd::search_strategy_t::depth_first}.solve();
+
+    WHEN(" the puzzle is solved without a deadline, reporting progress along the way")
+    {
+      auto puzzler = pnkd::puzzler{initial_state, strategy};
+      auto last_report = std::map<std::size_t, pnkd::game_state_t>{};
+      puzzler.on_progress([&last_report](auto const &solutions) { last_report = solutions; });
+
+      auto const solutions = puzzler.solve();
+
+      THEN(" every solution is proven optimal, and the last report had them all")
+      {
+        REQUIRE(solutions.size() == optimal.size());
+        REQUIRE(last_report.size() == optimal.size());
+
+        for (auto const &[combo, solution] : optimal)
+        {
+          REQUIRE(solutions.at(combo).proven());
+          REQUIRE(solutions.at(combo).route() == solution.route());
+          REQUIRE(last_report.at(combo).route() == solution.route());
+        }
+      }
+    }
+
+    WHEN(" the puzzle is solved with a deadline that has already passed")
+    {
+      auto const solutions = pnkd::puzzler{initial_state, strategy}.solve(std::chrono::steady_clock::now());
+
+      THEN(" any solution it claims is optimal really is")
+      {
+        for (auto const &[combo, solution] : solutions)
+        {
+          if (solution.proven())
+          {
+            REQUIRE(optimal.count(combo) == 1);
+            REQUIRE(solution.route() == optimal.at(combo).route());
+          }
+        }
+      }
+    }
+
+    WHEN(" the puzzle is solved on another thread")
+    {
+      auto puzzler = pnkd::puzzler{initial_state, strategy};
+      auto const solutions = puzzler.solve_async().get();
+
+      THEN(" it finds exactly the same routes")
+      {
+        REQUIRE(solutions.size() == optimal.size());
+
+        for (auto const &[combo, solution] : optimal)
+        {
+          REQUIRE(solutions.at(combo).route() == solution.route());
+        }
+      }
+    }
+
+    WHEN(" the puzzle is solved on another thread and cancelled straight away")
+    {
+      auto const cancel = pnkd::cancellation_token_t{};
+      cancel.cancel();
+
+      auto puzzler = pnkd::puzzler{initial_state, strategy};
+      auto solving = puzzler.solve_async(std::nullopt, cancel);
+
+      THEN(" it gives up, and any solution it claims is optimal really is")
+      {
+        REQUIRE(solving.wait_for(std::chrono::seconds{5}) == std::future_status::ready);
+
+        for (auto const &[combo, solution] : solving.get())
+        {
+          if (solution.proven())
+          {
+            REQUIRE(optimal.count(combo) == 1);
+            REQUIRE(solution.route() == optimal.at(combo).route());
+          }
+        }
+      }
+    }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////
+SCENARIO("Every buffer size at once", "[puzzler]")
+{
+  spdlog::set_level(spdlog::level::off);
+
+  GIVEN("A 5x5 grid, a set of 3 goals, and a buffer size of 8")
+  {
+    // clang-format off
+    auto const test_grid = std::vector<std::string>{
+      "1C", "BD", "BD", "1C", "BD",
+      "E9", "55", "E9", "55", "BD",
+      "BD", "1C", "E9", "55", "BD",
+      "BD", "55", "55", "1C", "BD",
+      "55", "BD", "55", "55", "1C"};
+
+    auto const goals = std::vector<std::vector<std::string>>{
+      {"1C", "BD"},
+      {"E9", "55", "1C"},
+      {"55", "55", "E9"}};
+    // clang-format on
+
+    auto const strategy = GENERATE(pnkd::search_strategy_t::breadth_first, pnkd::search_strategy_t::depth_first, pnkd::search_strategy_t::best_first, pnkd::search_strategy_t::sequence_first);
+
+    WHEN(" the puzzle is solved for every buffer size up to 8 in one go")
+    {
+      auto const table = pnkd::puzzler{pnkd::game_state_t{test_grid, pnkd::goal_list_t{goals}, 8}, strategy}.solve_every_buffer();
+
+      THEN(" each buffer size gets exactly the routes it would have got on its own")
+      {
+        REQUIRE(table.size() == 8);
+
+        for (std::size_t buffer_size = 1; buffer_size <= 8; ++buffer_size)
+        {
+          auto const solutions = pnkd::puzzler{pnkd::game_state_t{test_grid, pnkd::goal_list_t{goals}, buffer_size}, pnkd::search_strategy_t::depth_first}.solve();
+
+          REQUIRE(table.at(buffer_size).size() == solutions.size());
+
+          for (auto const &[combo, solution] : solutions)
+          {
+            REQUIRE(table.at(buffer_size).count(combo) == 1);
+            REQUIRE(table.at(buffer_size).at(combo).route().first_n(solution.scoring_moves()) == solution.route().first_n(solution.scoring_moves()));
+          }
+        }
+      }
+    }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////
+SCENARIO("Resuming a puzzle part way through", "[puzzler]")
+{
+  spdlog::set_level(spdlog::level::off);
+
+  GIVEN("A 5x5 grid, a set of 3 goals, and a buffer size of 8")
+  {
+    // clang-format off
+    auto const test_grid = std::vector<std::string>{
+      "1C", "BD", "BD", "1C", "BD",
+      "E9", "55", "E9", "55", "BD",
+      "BD", "1C", "E9", "55", "BD",
+      "BD", "55", "55", "1C", "BD",
+      "55", "BD", "55", "55", "1C"};
+
+    auto const goals = std::vector<std::vector<std::string>>{
+      {"1C", "BD"},
+      {"E9", "55", "1C"},
+      {"55", "55", "E9"}};
+    // clang-format on
+
+    auto const initial_state = pnkd::game_state_t{test_grid, pnkd::goal_list_t{goals}, 8};
+    auto const optimal = pnkd::puzzler{initial_state, pnkd::search_strategy_t::depth_first}.solve();
+
+    // The route that completes the most goals
+    auto const &[best_combo, best] = *std::max_element(std::begin(optimal), std::end(optimal), [](auto const &lhs, auto const &rhs) { return lhs.second.goals_completed() < rhs.second.goals_completed(); });
+
+    WHEN(" the first few moves of the best route are replayed")
+    {
+      auto const prefix = best.route().first_n(3);
+      auto const resumed = initial_state.replay(prefix);
+
+      THEN(" the state remembers where it's been")
+      {
+        REQUIRE(resumed.has_value());
+        REQUIRE(resumed->route() == prefix);
+        REQUIRE(resumed->moves_taken() == 3);
+        REQUIRE(resumed->position() == prefix.back());
+      }
+
+      AND_WHEN(" the rest of the puzzle is solved from there")
+      {
+        auto const strategy = GENERATE(pnkd::search_strategy_t::breadth_first, pnkd::search_strategy_t::depth_first, pnkd::search_strategy_t::best_first, pnkd::search_strategy_t::sequence_first);
+        auto const solutions = pnkd::puzzler{resumed.value(), strategy}.solve();
+
+        THEN(" every route starts with the moves already made, and the best one is still found")
+        {
+          for (auto const &[combo, solution] : solutions)
+          {
+            REQUIRE(solution.route().first_n(3) == prefix);
+          }
+
+          REQUIRE(solutions.count(best_combo) == 1);
+          REQUIRE(solutions.at(best_combo).route().first_n(best.scoring_moves()) == best.route().first_n(best.scoring_moves()));
+        }
+      }
+    }
+
+    WHEN(" the moves already made are read from the command line")
+    {
+      THEN(" they can be separated by commas, or written the way routes are shown")
+      {
+        REQUIRE(pnkd::parse_route("0,5, 8") == pnkd::route_t{{0, 5, 8}});
+        REQUIRE(pnkd::parse_route("0 -> 5 -> 8") == pnkd::route_t{{0, 5, 8}});
+        REQUIRE(!pnkd::parse_route("0,five").has_value());
+      }
+
+      THEN(" anything else between the moves, including a minus sign, is rejected")
+      {
+        REQUIRE(!pnkd::parse_route("-3").has_value());
+        REQUIRE(!pnkd::parse_route("0,-5").has_value());
+        REQUIRE(!pnkd::parse_route("0 - 5").has_value());
+        REQUIRE(!pnkd::parse_route("0,,5").has_value());
+        REQUIRE(!pnkd::parse_route("0 5").has_value());
+      }
+    }
+
+    WHEN(" a move that isn't allowed is replayed")
+    {
+      // The first move has to be on the top row
+      auto const resumed = initial_state.replay(pnkd::route_t{{5}});
+
+      THEN(" there's no state to resume from")
+      {
+        REQUIRE(!resumed.has_value());
+      }
+    }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////
+SCENARIO("Alternative routes", "[puzzler]")
+{
+  spdlog::set_level(spdlog::level::off);
+
+  GIVEN("A 5x5 grid, a set of 3 goals, and a buffer size of 7")
+  {
+    // clang-format off
+    auto const test_grid = std::vector<std::string>{
+      "1C", "BD", "BD", "1C", "BD",
+      "E9", "55", "E9", "55", "BD",
+      "BD", "1C", "E9", "55", "BD",
+      "BD", "55", "55", "1C", "BD",
+      "55", "BD", "55", "55", "1C"};
+
+    auto const goals = std::vector<std::vector<std::string>>{
+      {"1C", "BD"},
+      {"E9", "55", "1C"},
+      {"55", "55", "E9"}};
+    // clang-format on
+
+    auto const initial_state = pnkd::game_state_t{test_grid, pnkd::goal_list_t{goals}, 7};
+    auto const optimal = pnkd::puzzler{initial_state, pnkd::search_strategy_t::depth_first}.solve();
+
+    // Every route that completes a goal on its last move, by the goals it has completed by then
+    auto every_route = std::map<std::size_t, std::vector<std::pair<std::size_t, pnkd::route_t>>>{};
+    auto route = pnkd::route_t{};
+
+    auto const walk = [&every_route, &route](auto const &self, pnkd::game_state_t const &game_state) -> void {
+      for (std::size_t const move : game_state.list_all_valid_moves())
+      {
+        auto const next_game_state = game_state.make_move(move);
+
+        if (next_game_state)
+        {
+          route.push_back(move);
+
+          if (next_game_state->goal_combo() != game_state.goal_combo())
+          {
+            every_route[next_game_state->goal_combo()].emplace_back(next_game_state->scoring_moves(), route);
+          }
+
+          self(self, next_game_state.value());
+          route.pop_back();
+        }
+      }
+    };
+
+    walk(walk, initial_state);
+
+    WHEN(" the best 3 routes for each combination of goals are kept")
+    {
+      auto const threads = GENERATE(std::size_t{1}, std::size_t{4});
+      auto const alternatives = pnkd::puzzler{initial_state, pnkd::search_strategy_t::depth_first, threads}.solve_alternatives(3);
+
+      THEN(" they're the 3 routes with the fewest moves, in order, for the same combinations as the best routes")
+      {
+        REQUIRE(alternatives.size() == optimal.size());
+
+        for (auto const &[combo, solution] : optimal)
+        {
+          auto expected = every_route.at(combo);
+          std::sort(std::begin(expected), std::end(expected));
+          expected.resize(std::min(expected.size(), std::size_t{3}));
+
+          REQUIRE(alternatives.at(combo).size() == expected.size());
+          REQUIRE(alternatives.at(combo).front().route() == solution.route());
+
+          for (std::size_t i = 0; i < expected.size(); ++i)
+          {
+            REQUIRE(alternatives.at(combo)[i].scoring_moves() == expected[i].first);
+            REQUIRE(alternatives.at(combo)[i].route() == expected[i].second);
+          }
+        }
+      }
+    }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////
+SCENARIO("Weighted goals", "[puzzler]")
+{
+  spdlog::set_level(spdlog::level::off);
+
+  GIVEN("A 5x5 grid, a set of 3 goals, and a buffer size of 7")
+  {
+    // clang-format off
+    auto const test_grid = std::vector<std::string>{
+      "1C", "BD", "BD", "1C", "BD",
+      "E9", "55", "E9", "55", "BD",
+      "BD", "1C", "E9", "55", "BD",
+      "BD", "55", "55", "1C", "BD",
+      "55", "BD", "55", "55", "1C"};
+
+    auto const goals = std::vector<std::vector<std::string>>{
+      {"1C", "BD"},
+      {"E9", "55", "1C"},
+      {"55", "55", "E9"}};
+    // clang-format on
+
+    auto const initial_state = pnkd::game_state_t{test_grid, pnkd::goal_list_t{goals}, 7};
+
+    // Every route that completes a goal on its last move
+    auto every_route = std::vector<pnkd::game_state_t>{};
+    auto route = pnkd::route_t{};
+
+    auto const walk = [&every_route, &route](auto const &self, pnkd::game_state_t const &game_state) -> void {
+      for (std::size_t const move : game_state.list_all_valid_moves())
+      {
+        auto const next_game_state = game_state.make_move(move);
+
+        if (next_game_state)
+        {
+          route.push_back(move);
+
+          if (next_game_state->goal_combo() != game_state.goal_combo())
+          {
+            every_route.push_back(next_game_state.value());
+            every_route.back().set_route(route);
+          }
+
+          self(self, next_game_state.value());
+          route.pop_back();
+        }
+      }
+    };
+
+    walk(walk, initial_state);
+
+    THEN(" goals are weighted by their order unless told otherwise")
+    {
+      REQUIRE(pnkd::goal_weights_by_order(3) == std::vector<std::size_t>{1, 2, 3});
+    }
+
+    WHEN(" the route worth the most is wanted")
+    {
+      auto const weights = GENERATE(std::vector<std::size_t>{1, 2, 3}, std::vector<std::size_t>{5, 1, 1}, std::vector<std::size_t>{1, 1, 4});
+      auto const threads = GENERATE(std::size_t{1}, std::size_t{4});
+      auto const best = pnkd::puzzler{initial_state, pnkd::search_strategy_t::breadth_first, threads}.solve_weighted(weights);
+
+      auto const worth = [&weights](pnkd::game_state_t const &game_state) {
+        std::size_t total = 0;
+
+        for (std::size_t i = 0; i < weights.size(); ++i)
+        {
+          total += ((game_state.goal_combo() >> i) & 1U) ? weights[i] : 0;
+        }
+
+        return total;
+      };
+
+      THEN(" it's worth the most of any route, then takes the fewest moves, then comes first")
+      {
+        auto const expected = *std::min_element(std::begin(every_route), std::end(every_route), [&worth](auto const &lhs, auto const &rhs) {
+          return std::make_tuple(worth(rhs), lhs.scoring_moves(), lhs.route()) < std::make_tuple(worth(lhs), rhs.scoring_moves(), rhs.route());
+        });
+
+        REQUIRE(best.has_value());
+        REQUIRE(best->goal_combo() == expected.goal_combo());
+        REQUIRE(best->scoring_moves() == expected.scoring_moves());
+        REQUIRE(best->route() == expected.route());
+        REQUIRE(best->proven());
+      }
+    }
+
+    WHEN(" a goal is missing its weight, or is worth nothing")
+    {
+      THEN(" there's no answer")
+      {
+        REQUIRE_FALSE(pnkd::puzzler{initial_state}.solve_weighted({1, 2}).has_value());
+        REQUIRE_FALSE(pnkd::puzzler{initial_state}.solve_weighted({1, 0, 2}).has_value());
+      }
+    }
+
+    WHEN(" the weights are read from the command line")
+    {
+      THEN(" they're whole numbers separated by commas")
+      {
+        REQUIRE(pnkd::parse_numbers("1,2,5") == std::vector<std::size_t>{1, 2, 5});
+        REQUIRE(pnkd::parse_numbers("1, 2, 5") == std::vector<std::size_t>{1, 2, 5});
+      }
+
+      THEN(" a missing weight, or anything else between them, is rejected")
+      {
+        REQUIRE(!pnkd::parse_numbers("1,,2").has_value());
+        REQUIRE(!pnkd::parse_numbers("1,2,").has_value());
+        REQUIRE(!pnkd::parse_numbers("1,-2").has_value());
+        REQUIRE(!pnkd::parse_numbers("1 2").has_value());
+      }
+    }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////
+SCENARIO("Beam search", "[puzzler]")
+{
+  spdlog::set_level(spdlog::level::off);
+
+  GIVEN("A 5x5 grid, a set of 3 goals, and a buffer size of 7")
+  {
+    // clang-format off
+    auto const test_grid = std::vector<std::string>{
+      "1C", "BD", "BD", "1C", "BD",
+      "E9", "55", "E9", "55", "BD",
+      "BD", "1C", "E9", "55", "BD",
+      "BD", "55", "55", "1C", "BD",
+      "55", "BD", "55", "55", "1C"};
+
+    auto const goals = std::vector<std::vector<std::string>>{
+      {"1C", "BD"},
+      {"E9", "55", "1C"},
+      {"55", "55", "E9"}};
+    // clang-format on
+
+    auto const initial_state = pnkd::game_state_t{test_grid, pnkd::goal_list_t{goals}, 7};
+    auto const optimal = pnkd::puzzler{initial_state, pnkd::search_strategy_t::depth_first}.solve();
+
+    auto const beam_search = [&initial_state](std::size_t const width) {
+      auto puzzler = pnkd::puzzler{initial_state, pnkd::search_strategy_t::beam};
+      puzzler.set_beam_width(width);
+
+      return puzzler.solve();
+    };
+
+    WHEN(" the beam is wide enough to keep every state")
+    {
+      auto const solutions = beam_search(100000);
+
+      THEN(" it finds the same routes as the exact search, and they're proven optimal")
+      {
+        REQUIRE(solutions.size() == optimal.size());
+
+        for (auto const &[combo, solution] : optimal)
+        {
+          REQUIRE(solutions.at(combo).route() == solution.route());
+          REQUIRE(solutions.at(combo).proven());
+        }
+
+        auto const gap = pnkd::measure_quality_gap(optimal, solutions);
+
+        REQUIRE(gap.m_combos == optimal.size());
+        REQUIRE(gap.m_optimal == optimal.size());
+        REQUIRE(gap.m_missed == 0);
+        REQUIRE(gap.m_extra_moves == 0);
+        REQUIRE(gap.m_goals_missed == 0);
+      }
+    }
+
+    WHEN(" the beam only keeps one state at each depth")
+    {
+      auto const solutions = beam_search(1);
+      auto const gap = pnkd::measure_quality_gap(optimal, solutions);
+
+      THEN(" every route it finds is real, and only the ones that can't be beaten are proven optimal")
+      {
+        REQUIRE_FALSE(solutions.empty());
+
+        for (auto const &[combo, solution] : solutions)
+        {
+          auto const replayed = initial_state.replay(solution.route());
+
+          REQUIRE(replayed.has_value());
+          REQUIRE(replayed->goal_combo() == combo);
+          REQUIRE(replayed->scoring_moves() == solution.scoring_moves());
+
+          if (solution.proven())
+          {
+            REQUIRE(solution.scoring_moves() <= optimal.at(combo).scoring_moves());
+          }
+        }
+      }
+
+      THEN(" it falls short of the exact search somewhere")
+      {
+        REQUIRE(gap.m_combos == optimal.size());
+        REQUIRE(gap.m_optimal < gap.m_combos);
+        REQUIRE(gap.m_optimal + gap.m_missed <= gap.m_combos);
+        REQUIRE((gap.m_missed != 0 || gap.m_extra_moves != 0));
+      }
+    }
+
+    WHEN(" nothing is found at all")
+    {
+      auto const gap = pnkd::measure_quality_gap(optimal, {});
+
+      THEN(" every combination is missed, and so are the goals of the best route")
+      {
+        REQUIRE(gap.m_missed == optimal.size());
+        REQUIRE(gap.m_optimal == 0);
+        REQUIRE(gap.m_goals_missed == 3);
+      }
+    }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////
+SCENARIO("Sequence-first solving", "[sequencer]")
+{
+  spdlog::set_level(spdlog::level::off);
+
+  GIVEN("A goal and a sequence of codes that ends with the start of it")
+  {
+    auto const pattern = pnkd::symbol_seq_t{0, 1, 2, 1, 2, 1};
+    auto const goal = pnkd::symbol_seq_t{1, 2, 1, 3};
+
+    THEN(" every way they can overlap is found, longest first")
+    {
+      REQUIRE(pnkd::overlaps(pattern, goal) == std::vector<std::size_t>{3, 1});
+      REQUIRE(pnkd::overlaps(pnkd::symbol_seq_t{3, 3}, goal).empty());
+    }
+  }
+
+  GIVEN("A 5x5 grid, a set of 3 goals, and a buffer size of 8")
+  {
+    // clang-format off
+    auto const test_grid = std::vector<std::string>{
+      "1C", "BD", "BD", "1C", "BD", 
+      "E9", "55", "E9", "55", "BD", 
+      "BD", "1C", "E9", "55", "BD", 
+      "BD", "55", "55", "1C", "BD", 
+      "55", "BD", "55", "55", "1C"};
+
+    auto const goals = std::vector<std::vector<std::string>>{
+      {"1C", "BD"}, 
+      {"E9", "55", "1C"}, 
+      {"55", "55", "E9"}};
+    // clang-format on
+
+    auto const initial_state = pnkd::game_state_t{test_grid, pnkd::goal_list_t{goals}, 8};
+
+    WHEN(" the puzzle is solved by searching the grid and by spelling out the goals")
+    {
+      auto bfs = pnkd::puzzler{initial_state, pnkd::search_strategy_t::breadth_first};
+      auto const bfs_solutions = bfs.solve();
+
+      auto const sequence_solutions = pnkd::sequencer{initial_state}.solve();
+
+      THEN(" both find exactly the same routes")
+      {
+        REQUIRE(sequence_solutions.size() == bfs_solutions.size());
+
+        for (auto const &[combo, solution] : bfs_solutions)
+        {
+          REQUIRE(sequence_solutions.count(combo) == 1);
+          REQUIRE(sequence_solutions.at(combo).route() == solution.route());
+          REQUIRE(sequence_solutions.at(combo).scoring_moves() == solution.scoring_moves());
+        }
+      }
+    }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////
+SCENARIO("Path oracle", "[oracle]")
+{
+  spdlog::set_level(spdlog::level::off);
+
+  GIVEN("A 5x5 grid and a buffer size of 4")
+  {
+    // clang-format off
+    auto const test_grid = std::vector<std::string>{
+      "1C", "BD", "BD", "1C", "BD", 
+      "E9", "55", "E9", "55", "BD", 
+      "BD", "1C", "E9", "55", "BD", 
+      "BD", "55", "55", "1C", "BD", 
+      "55", "BD", "55", "55", "1C"};
+    // clang-format on
+
+    auto const puzzle = pnkd::puzzle_t{test_grid, pnkd::goal_list_t{}, 4};
+    auto const oracle = pnkd::path_oracle_t{puzzle};
+
+    auto const symbols = [&puzzle](std::vector<std::string> const &codes) {
+      auto seq = pnkd::symbol_seq_t{};
+
+      for (auto const &code : codes)
+      {
+        seq.push_back(puzzle.alphabet().find(code));
+      }
+
+      return seq;
+    };
+
+    THEN(" it finds the first route that spells a sequence without reusing any cells")
+    {
+      REQUIRE(oracle.find(symbols({"1C", "E9"})) == pnkd::route_t{{0, 5}});
+      REQUIRE(oracle.find(symbols({"BD", "BD", "BD"})) == pnkd::route_t{{4, 14, 10}});
+      REQUIRE(oracle.find(pnkd::symbol_seq_t{pnkd::path_oracle_t::any_symbol, puzzle.alphabet().find("E9")}) == pnkd::route_t{{0, 5}});
+    }
+
+    THEN(" it knows when there's no such route")
+    {
+      REQUIRE(!oracle.find(symbols({"E9"})));
+      REQUIRE(!oracle.find(symbols({"1C", "E9", "55", "BD", "1C"})));
+    }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////
+SCENARIO("Board geometry", "[puzzle]")
+{
+  spdlog::set_level(spdlog::level::off);
+
+  GIVEN("A compile-time board and a runtime board of each width the game uses")
+  {
+    auto const same_lines = [](auto const &board, pnkd::dynamic_board_t const &dynamic) {
+      // Every line through a cell, and every spread of the first few cells, has to agree
+      for (std::size_t pos = 0; pos < dynamic.grid_width() * dynamic.grid_width(); ++pos)
+      {
+        pnkd::cell_mask_t const cells = (pnkd::cell_mask_t{1} << pos) | (pnkd::cell_mask_t{1} << (pos / 2));
+
+        if (board.line_mask(pos, false) != dynamic.line_mask(pos, false) || board.line_mask(pos, true) != dynamic.line_mask(pos, true) || board.spread(cells, false) != dynamic.spread(cells, false) || board.spread(cells, true) != dynamic.spread(cells, true))
+        {
+          return false;
+        }
+      }
+
+      return board.all_cells() == dynamic.all_cells();
+    };
+
+    THEN(" they have the same rows and columns")
+    {
+      REQUIRE(same_lines(pnkd::board_t<5>{}, pnkd::dynamic_board_t{5}));
+      REQUIRE(same_lines(pnkd::board_t<6>{}, pnkd::dynamic_board_t{6}));
+      REQUIRE(same_lines(pnkd::board_t<7>{}, pnkd::dynamic_board_t{7}));
+      REQUIRE(same_lines(pnkd::board_t<8>{}, pnkd::dynamic_board_t{8}));
+    }
+
+    THEN(" the rows and columns are where they should be")
+    {
+      REQUIRE(pnkd::board_t<5>{}.line_mask(7, false) == 0x3E0);
+      REQUIRE(pnkd::board_t<5>{}.line_mask(7, true) == 0x108421 << 2);
+      REQUIRE(pnkd::board_t<8>{}.line_mask(63, false) == 0xFF00000000000000);
+      REQUIRE(pnkd::board_t<8>{}.all_cells() == ~pnkd::cell_mask_t{0});
+    }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////
+SCENARIO("Larger boards", "[puzzler]")
+{
+  spdlog::set_level(spdlog::level::off);
+
+  GIVEN("An 8x8 grid, a set of 8 goals, and a buffer size of 7")
+  {
+    // clang-format off
+    auto const test_grid = std::vector<std::string>{
+      "BD", "55", "E9", "FF", "1C", "1C", "7A", "1C", 
+      "BD", "7A", "1C", "7A", "55", "1C", "1C", "E9", 
+      "E9", "1C", "55", "1C", "7A", "E9", "1C", "7A", 
+      "1C", "55", "FF", "FF", "7A", "1C", "7A", "7A", 
+      "E9", "1C", "55", "1C", "7A", "55", "BD", "E9", 
+      "55", "7A", "1C", "7A", "BD", "7A", "FF", "55", 
+      "1C", "7A", "7A", "FF", "55", "BD", "1C", "7A", 
+      "FF", "1C", "7A", "1C", "7A", "55", "E9", "FF"};
+
+    auto const goals = std::vector<std::vector<std::string>>{
+      {"7A", "E9"}, 
+      {"BD", "E9", "7A"}, 
+      {"E9", "BD"}, 
+      {"BD", "55", "55"}, 
+      {"FF", "55"}, 
+      {"1C", "7A", "BD"}, 
+      {"55", "1C"}, 
+      {"BD", "FF", "E9"}};
+    // clang-format on
+
+    auto const initial_state = pnkd::game_state_t{test_grid, pnkd::goal_list_t{goals}, 7};
+
+    WHEN(" the puzzle is solved with each strategy")
+    {
+      auto const bfs_solutions = pnkd::puzzler{initial_state, pnkd::search_strategy_t::breadth_first}.solve();
+      auto const dfs_solutions = pnkd::puzzler{initial_state, pnkd::search_strategy_t::depth_first}.solve();
+      auto const seq_solutions = pnkd::puzzler{initial_state, pnkd::search_strategy_t::sequence_first}.solve();
+      auto const best_solutions = pnkd::puzzler{initial_state, pnkd::search_strategy_t::best_first}.solve();
+
+      THEN(" they all find exactly the same routes")
+      {
+        REQUIRE(!dfs_solutions.empty());
+        REQUIRE(bfs_solutions.size() == dfs_solutions.size());
+        REQUIRE(seq_solutions.size() == dfs_solutions.size());
+        REQUIRE(best_solutions.size() == dfs_solutions.size());
+
+        for (auto const &[combo, solution] : dfs_solutions)
+        {
+          REQUIRE(bfs_solutions.count(combo) == 1);
+          REQUIRE(bfs_solutions.at(combo).route() == solution.route());
+          REQUIRE(seq_solutions.count(combo) == 1);
+          REQUIRE(seq_solutions.at(combo).route() == solution.route());
+          REQUIRE(best_solutions.count(combo) == 1);
+          REQUIRE(best_solutions.at(combo).route() == solution.route());
+        }
+      }
+
+      THEN(" goals past the fifth one can be completed")
+      {
+        REQUIRE(std::any_of(std::begin(dfs_solutions), std::end(dfs_solutions), [](auto const &solution) { return (solution.first >> 5U) != 0; }));
+      }
+    }
+  }
+
+  GIVEN("A puzzle too big for the solver")
+  {
+    auto const goals = std::vector<std::vector<std::string>>{{"BD", "55"}, {"55", "BD"}};
+    auto const too_many_goals = std::vector<std::vector<std::string>>(9, {"BD", "55"});
+
+    auto const grid_8x8 = std::vector<std::string>(64, "BD");
+    auto const grid_9x9 = std::vector<std::string>(81, "BD");
+    auto const grid_8x9 = std::vector<std::string>(72, "BD");
+
+    THEN(" it is rejected, rather than solved as some other puzzle")
+    {
+      REQUIRE_THROWS_AS((pnkd::puzzle_t{grid_9x9, pnkd::goal_list_t{goals}, 7}), std::invalid_argument);
+      REQUIRE_THROWS_AS((pnkd::game_state_t{grid_9x9, pnkd::goal_list_t{goals}, 7}), std::invalid_argument);
+      REQUIRE_THROWS_AS((pnkd::puzzle_t{grid_8x8, pnkd::goal_list_t{too_many_goals}, 7}), std::invalid_argument);
+    }
+
+    THEN(" so is a grid that isn't square")
+    {
+      REQUIRE_THROWS_AS((pnkd::puzzle_t{grid_8x9, pnkd::goal_list_t{goals}, 7}), std::invalid_argument);
+      REQUIRE_NOTHROW((pnkd::puzzle_t{grid_8x8, pnkd::goal_list_t{goals}, 7}));
+    }
+  }
+}
+
+
+////////////////////////////////////////////////////////////////
+SCENARIO("Solver latency", "[.][benchmark]")
+{
+  spdlog::set_level(spdlog::level::off);
+
+  auto const &grid_7x7 = pnkd::benchmark_grid_7x7;
+  auto const &grid_8x8 = pnkd::benchmark_grid_8x8;
+  auto const &goals = pnkd::benchmark_goals;
+
+  auto const few_goals = std::vector<std::vector<std::string>>{std::begin(goals), std::next(std::begin(goals), 3)};
+
+  auto const solve = [](std::vector<std::string> const &grid, std::vector<std::vector<std::string>> const &goal_seqs, std::size_t const buffer_size, pnkd::search_strategy_t const strategy) {
+    return pnkd::puzzler{pnkd::game_state_t{grid, pnkd::goal_list_t{goal_seqs}, buffer_size}, strategy}.solve();
+  };
+
+  BENCHMARK("7x7, 3 goals, buffer 10, dfs")
+  {
+    return solve(grid_7x7, few_goals, 10, pnkd::search_strategy_t::depth_first);
+  };
+
+  BENCHMARK("7x7, 8 goals, buffer 10, seq")
+  {
+    return solve(grid_7x7, goals, 10, pnkd::search_strategy_t::sequence_first);
+  };
+
+  BENCHMARK("8x8, 3 goals, buffer 10, dfs")
+  {
+    return solve(grid_8x8, few_goals, 10, pnkd::search_strategy_t::depth_first);
+  };
+
+  BENCHMARK("8x8, 8 goals, buffer 8, dfs")
+  {
+    return solve(grid_8x8, goals, 8, pnkd::search_strategy_t::depth_first);
+  };
+
+  BENCHMARK("8x8, 8 goals, buffer 10, seq")
+  {
+    return solve(grid_8x8, goals, 10, pnkd::search_strategy_t::sequence_first);
+  };
+}
+
+
+////////////////////////////////////////////////////////////////
+SCENARIO("Beam search quality", "[.][benchmark]")
+{
+  spdlog::set_level(spdlog::level::off);
+
+  auto const &goals = pnkd::benchmark_goals;
+  auto const few_goals = std::vector<std::vector<std::string>>{std::begin(goals), std::next(std::begin(goals), 3)};
+
+  // Each puzzle, and the exact search that's quickest for it
+  struct puzzle_case_t
+  {
+    pnkd::game_state_t m_state;
+    pnkd::search_strategy_t m_exact;
+  };
+
+  auto corpus = std::vector<puzzle_case_t>{};
+
+  for (auto const *grid : {&pnkd::benchmark_grid_7x7, &pnkd::benchmark_grid_8x8})
+  {
+    for (std::size_t const buffer_size : {8, 10, 12})
+    {
+      corpus.push_back(puzzle_case_t{pnkd::game_state_t{*grid, pnkd::goal_list_t{few_goals}, buffer_size}, pnkd::search_strategy_t::depth_first});
+      corpus.push_back(puzzle_case_t{pnkd::game_state_t{*grid, pnkd::goal_list_t{goals}, buffer_size}, pnkd::search_strategy_t::sequence_first});
+    }
+  }
+
+  auto const time_solve = [](pnkd::puzzler &puzzler) {
+    auto const start = std::chrono::steady_clock::now();
+    auto solutions = puzzler.solve();
+
+    return std::make_pair(std::move(solutions), std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+  };
+
+  auto optimal = std::vector<std::map<std::size_t, pnkd::game_state_t>>{};
+  double exact_ms = 0;
+
+  for (auto const &puzzle : corpus)
+  {
+    auto puzzler = pnkd::puzzler{puzzle.m_state, puzzle.m_exact};
+    auto [solutions, ms] = time_solve(puzzler);
+
+    optimal.push_back(std::move(solutions));
+    exact_ms += ms;
+  }
+
+  WARN(fmt::format("Exact: {} puzzles in {:.1f}ms", corpus.size(), exact_ms));
+
+  // How much each beam width gives up against the exact routes, added up over every puzzle
+  for (std::size_t const width : {16, 64, 256, 1024, 4096})
+  {
+    auto total = pnkd::quality_gap_t{};
+    std::size_t puzzles_short_of_goals = 0;
+    double beam_ms = 0;
+
+    for (std::size_t i = 0; i < corpus.size(); ++i)
+    {
+      auto puzzler = pnkd::puzzler{corpus[i].m_state, pnkd::search_strategy_t::beam};
+      puzzler.set_beam_width(width);
+
+      auto const [solutions, ms] = time_solve(puzzler);
+      auto const gap = pnkd::measure_quality_gap(optimal[i], solutions);
+
+      total.m_combos += gap.m_combos;
+      total.m_optimal += gap.m_optimal;
+      total.m_missed += gap.m_missed;
+      total.m_extra_moves += gap.m_extra_moves;
+      total.m_goals_missed += gap.m_goals_missed;
+      puzzles_short_of_goals += gap.m_goals_missed != 0 ? 1 : 0;
+      beam_ms += ms;
+    }
+
+    WARN(fmt::format("Beam {}: {:.1f}ms, {} of {} combinations optimal, {} missed, {} extra moves, best route short of goals on {} of {} puzzles ({} goals in all)", width, beam_ms, total.m_optimal, total.m_combos, total.m_missed, total.m_extra_moves, puzzles_short_of_goals, corpus.size(), total.m_goals_missed));
+
+    REQUIRE(total.m_optimal + total.m_missed <= total.m_combos);
+  }
+}